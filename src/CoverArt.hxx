@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "util/ASCII.hxx"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * The file names which are probed for album art (command
+ * "albumart"), in the order of preference.
+ */
+inline constexpr std::array cover_art_names{
+	std::string_view{"cover.png"},
+	std::string_view{"cover.jpg"},
+	std::string_view{"cover.webp"},
+};
+
+/**
+ * The comparison ignores case, because on case-insensitive storage
+ * (e.g. SMB shares), "Cover.JPG" is served by probing "cover.jpg".
+ *
+ * @return the index of the given file name in #cover_art_names or
+ * cover_art_names.size() if this is not a cover art file name
+ */
+[[gnu::pure]]
+inline std::size_t
+FindCoverArtName(std::string_view name) noexcept
+{
+	std::size_t i = 0;
+	for (const auto j : cover_art_names) {
+		if (name.size() == j.size() &&
+		    StringEqualsCaseASCII(name.data(), j.data(), j.size()))
+			break;
+		++i;
+	}
+
+	return i;
+}
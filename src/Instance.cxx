@@ -8,6 +8,7 @@
 #include "StateFile.hxx"
 #include "Stats.hxx"
 #include "client/List.hxx"
+#include "client/IOThreads.hxx"
 #include "input/cache/Manager.hxx"
 
 #ifdef ENABLE_CURL
@@ -19,6 +20,8 @@
 #include "db/DatabaseError.hxx"
 #include "db/Interface.hxx"
 #include "db/update/Service.hxx"
+#include "db/cache/QueryCache.hxx"
+#include "db/cache/PictureCache.hxx"
 #include "storage/StorageInterface.hxx"
 
 #ifdef ENABLE_INOTIFY
@@ -48,6 +51,11 @@ Instance::~Instance() noexcept
 #endif
 
 #ifdef ENABLE_DATABASE
+	/* dispose all clients before closing the database, because
+	   a client's background command may still be querying it
+	   in a worker thread */
+	client_list.reset();
+
 	delete update;
 
 	if (database != nullptr) {
@@ -118,6 +126,16 @@ Instance::GetDatabaseOrThrow() const
 	return *database;
 }
 
+void
+Instance::InvalidateDatabaseCaches() noexcept
+{
+	if (query_cache)
+		query_cache->Invalidate();
+
+	if (picture_cache)
+		picture_cache->Invalidate();
+}
+
 void
 Instance::OnDatabaseModified() noexcept
 {
@@ -127,6 +145,8 @@ Instance::OnDatabaseModified() noexcept
 
 	stats_invalidate();
 
+	InvalidateDatabaseCaches();
+
 	for (auto &partition : partitions)
 		partition.DatabaseModified(*database);
 
@@ -214,6 +234,10 @@ Instance::FlushCaches() noexcept
 {
 	if (input_cache)
 		input_cache->Flush();
+
+#ifdef ENABLE_DATABASE
+	InvalidateDatabaseCaches();
+#endif
 }
 
 void
@@ -26,9 +26,12 @@ class NeighborGlue;
 #ifdef ENABLE_DATABASE
 #include "db/DatabaseListener.hxx"
 #include "db/Ptr.hxx"
+#include "client/ThreadBackgroundQueue.hxx"
 
 class Storage;
 class UpdateService;
+class QueryCache;
+class PictureCache;
 #ifdef ENABLE_INOTIFY
 class InotifyUpdate;
 #endif
@@ -38,6 +41,7 @@ class InotifyUpdate;
 #include <list>
 
 class ClientList;
+class ClientIOThreads;
 struct Partition;
 class AudioOutputControl;
 class StateFile;
@@ -112,6 +116,32 @@ struct Instance final
 
 	UpdateService *update = nullptr;
 
+	/**
+	 * Caches responses of "find" and "search".  This is nullptr
+	 * if the "query_cache" block was not configured.
+	 */
+	std::unique_ptr<QueryCache> query_cache;
+
+	/**
+	 * Caches pictures served by "albumart" and "readpicture".
+	 * This is nullptr if the "picture_cache" block was not
+	 * configured.
+	 */
+	std::unique_ptr<PictureCache> picture_cache;
+
+	/**
+	 * The number of database queries running in worker threads
+	 * or waiting for one (see DatabaseQueryCommand).  While this
+	 * is non-zero, mounted databases must not be removed.
+	 */
+	unsigned n_database_query_threads = 0;
+
+	/**
+	 * Limits the number of database queries running in worker
+	 * threads at the same time; the others wait in this queue.
+	 */
+	ThreadBackgroundQueue database_query_queue{4};
+
 #ifdef ENABLE_INOTIFY
 	std::unique_ptr<InotifyUpdate> inotify_update;
 #endif
@@ -121,6 +151,15 @@ struct Instance final
 	std::unique_ptr<RemoteTagCache> remote_tag_cache;
 #endif
 
+	/**
+	 * Threads doing the socket I/O of clients; nullptr if
+	 * "client_threads" is not configured (then all client I/O
+	 * happens in the main thread).  This must be declared before
+	 * #client_list, because the threads must outlive all
+	 * clients.
+	 */
+	std::unique_ptr<ClientIOThreads> client_io_threads;
+
 	std::unique_ptr<ClientList> client_list;
 
 	std::list<Partition> partitions;
@@ -200,6 +239,12 @@ struct Instance final
 	 * music_directory was configured).
 	 */
 	const Database &GetDatabaseOrThrow() const;
+
+	/**
+	 * Discard everything which was cached from the database.
+	 * Must be called whenever the database gets modified.
+	 */
+	void InvalidateDatabaseCaches() noexcept;
 #endif
 
 #ifdef ENABLE_SQLITE
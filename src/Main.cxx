@@ -13,6 +13,7 @@
 #include "Listen.hxx"
 #include "client/Config.hxx"
 #include "client/List.hxx"
+#include "client/IOThreads.hxx"
 #include "command/AllCommands.hxx"
 #include "Partition.hxx"
 #include "tag/Config.hxx"
@@ -59,6 +60,9 @@
 #include "db/Configured.hxx"
 #include "db/DatabasePlugin.hxx"
 #include "db/plugins/simple/SimpleDatabasePlugin.hxx"
+#include "db/cache/Config.hxx"
+#include "db/cache/QueryCache.hxx"
+#include "db/cache/PictureCache.hxx"
 #include "storage/Configured.hxx"
 #include "storage/CompositeStorage.hxx"
 #ifdef ENABLE_INOTIFY
@@ -211,6 +215,16 @@ glue_db_init_and_load(Instance &instance, const ConfigData &config)
 
 	instance.database = std::move(db);
 
+	if (const auto *block = config.GetBlock(ConfigBlockOption::QUERY_CACHE)) {
+		const QueryCacheConfig c(*block);
+		instance.query_cache = std::make_unique<QueryCache>(c);
+	}
+
+	if (const auto *block = config.GetBlock(ConfigBlockOption::PICTURE_CACHE)) {
+		const PictureCacheConfig c(*block);
+		instance.picture_cache = std::make_unique<PictureCache>(c);
+	}
+
 	auto *sdb = dynamic_cast<SimpleDatabase *>(instance.database.get());
 	if (sdb == nullptr)
 		return true;
@@ -353,6 +367,12 @@ MainConfigured(const CommandLineOptions &options,
 		raw_config.GetPositive(ConfigOption::MAX_CONN, 100);
 	instance.client_list = std::make_unique<ClientList>(max_clients);
 
+	if (const unsigned n_client_threads =
+	    raw_config.GetUnsigned(ConfigOption::CLIENT_THREADS, 0);
+	    n_client_threads > 0)
+		instance.client_io_threads =
+			std::make_unique<ClientIOThreads>(n_client_threads);
+
 	const auto *input_cache_config = raw_config.GetBlock(ConfigBlockOption::INPUT_CACHE);
 	if (input_cache_config != nullptr) {
 		const InputCacheConfig c(*input_cache_config);
@@ -434,6 +454,9 @@ MainConfigured(const CommandLineOptions &options,
 	instance.io_thread.Start();
 	instance.rtio_thread.Start();
 
+	if (instance.client_io_threads)
+		instance.client_io_threads->Start();
+
 #ifdef ENABLE_NEIGHBOR_PLUGINS
 	if (instance.neighbors != nullptr)
 		instance.neighbors->Open();
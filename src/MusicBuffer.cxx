@@ -5,34 +5,86 @@
 #include "MusicChunk.hxx"
 
 #include <cassert>
+#include <new>
 
-MusicBuffer::MusicBuffer(unsigned num_chunks)
-	:buffer(num_chunks)
+/**
+ * Round up to the alignment of #MusicChunk, so each chunk in the
+ * array is properly aligned.
+ */
+static constexpr std::size_t
+AlignChunkSize(std::size_t size) noexcept
 {
-	buffer.SetName("MusicBuffer");
+	constexpr std::size_t alignment = alignof(MusicChunk);
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+MusicBuffer::MusicBuffer(unsigned num_chunks, std::size_t _chunk_size)
+	:chunk_size(AlignChunkSize(_chunk_size)),
+	 n_chunks(num_chunks),
+	 memory(std::size_t{num_chunks} * chunk_size)
+{
+	assert(chunk_size >= CHUNK_SIZE);
+
+	memory.ForkCow(false);
+	memory.SetName("MusicBuffer");
+}
+
+void
+MusicBuffer::DiscardMemory() noexcept
+{
+	assert(IsEmptyUnsafe());
+
+	returned.store(nullptr, std::memory_order_relaxed);
+	available = nullptr;
+	n_initialized = 0;
+	memory.Discard();
 }
 
 MusicChunkPtr
 MusicBuffer::Allocate() noexcept
 {
-	const std::scoped_lock protect{mutex};
-	return {buffer.Allocate(), MusicChunkDeleter(*this)};
+	/* prefer reusing returned chunks (which are probably still
+	   hot in the CPU cache) over initializing new ones */
+	if (available == nullptr)
+		available = returned.exchange(nullptr,
+					      std::memory_order_acquire);
+
+	void *p;
+	if (available != nullptr) {
+		auto *node = available;
+		available = node->next;
+		node->~FreeChunk();
+		p = node;
+	} else if (n_initialized < n_chunks) {
+		p = GetChunk(n_initialized++);
+	} else
+		/* buffer is full */
+		return {nullptr, MusicChunkDeleter(*this)};
+
+	n_allocated.fetch_add(1, std::memory_order_relaxed);
+
+	auto *chunk = ::new(p) MusicChunk(GetChunkDataSize());
+	return {chunk, MusicChunkDeleter(*this)};
 }
 
 void
 MusicBuffer::Return(MusicChunk *chunk) noexcept
 {
 	assert(chunk != nullptr);
+	assert(!chunk->other || !chunk->other->other);
+	assert(reinterpret_cast<std::byte *>(chunk) >= &memory.front() &&
+	       reinterpret_cast<std::byte *>(chunk) <= &memory.back());
 
-	/* these attributes need to be cleared before locking the
-	   mutex, because they might recursively call this method,
-	   causing a deadlock */
-	chunk->next.reset();
-	chunk->other.reset();
-
-	const std::scoped_lock protect{mutex};
+	/* destruct the chunk here (which may recursively return
+	   the "next" and "other" chunks); the memory is then reused
+	   for the FreeChunk */
+	chunk->~MusicChunk();
 
-	assert(!chunk->other || !chunk->other->other);
+	auto *node = ::new(static_cast<void *>(chunk)) FreeChunk;
+	node->next = returned.load(std::memory_order_relaxed);
+	while (!returned.compare_exchange_weak(node->next, node,
+					       std::memory_order_release,
+					       std::memory_order_relaxed)) {}
 
-	buffer.Free(chunk);
+	n_allocated.fetch_sub(1, std::memory_order_relaxed);
 }
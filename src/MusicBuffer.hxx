@@ -5,17 +5,75 @@
 
 #include "MusicChunk.hxx"
 #include "MusicChunkPtr.hxx"
-#include "memory/SliceBuffer.hxx"
-#include "thread/Mutex.hxx"
+#include "memory/HugeArray.hxx"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
 
 /**
  * An allocator for #MusicChunk objects.
+ *
+ * All chunks are allocated from one "huge" memory area; each
+ * allocation consists of the #MusicChunk object followed by its data
+ * buffer, and the size of each allocation is chosen at runtime.
+ *
+ * Allocate() may only be called by one thread at a time (the
+ * decoder thread), but Return() may be called by any thread.  Both
+ * are lock-free: returned chunks are collected in a lock-free stack
+ * which is moved to the #available list by Allocate().
  */
 class MusicBuffer {
-	/** a mutex which protects #buffer */
-	mutable Mutex mutex;
+	/**
+	 * A free chunk in the #returned stack or in the #available
+	 * list.  It is constructed in the memory of the (destructed)
+	 * #MusicChunk.
+	 */
+	struct FreeChunk {
+		FreeChunk *next;
+	};
+
+	/**
+	 * Chunks which were passed to Return(), but have not yet been
+	 * moved to #available.  Any thread may push to this stack,
+	 * but only Allocate() removes items (all at once), which is
+	 * why there is no ABA problem.
+	 */
+	std::atomic<FreeChunk *> returned{nullptr};
+
+	/**
+	 * The number of chunks which are currently allocated (not
+	 * counting those in #returned).
+	 */
+	std::atomic_uint n_allocated{0};
+
+	/**
+	 * The size of each allocation (#MusicChunk plus data) in
+	 * bytes.
+	 */
+	const std::size_t chunk_size;
+
+	const unsigned n_chunks;
+
+	HugeArray<std::byte> memory;
+
+	/*
+	 * The following attributes are only accessed by Allocate()
+	 * and by the "unsafe" methods.
+	 */
+
+	/**
+	 * The number of chunks at the beginning of #memory which
+	 * have been used at least once.  This is used to avoid page
+	 * faulting on the new allocation, so the kernel does not need
+	 * to reserve physical memory pages.
+	 */
+	unsigned n_initialized = 0;
 
-	SliceBuffer<MusicChunk> buffer;
+	/**
+	 * Free chunks which can be reused by Allocate().
+	 */
+	FreeChunk *available = nullptr;
 
 public:
 	/**
@@ -23,24 +81,33 @@ public:
 	 *
 	 * @param num_chunks the number of #MusicChunk reserved in
 	 * this buffer
+	 * @param chunk_size the size of each chunk in bytes
+	 * (including the #MusicChunk object); must be at least
+	 * #CHUNK_SIZE
 	 */
-	explicit MusicBuffer(unsigned num_chunks);
+	explicit MusicBuffer(unsigned num_chunks,
+			     std::size_t chunk_size=CHUNK_SIZE);
+
+	~MusicBuffer() noexcept {
+		/* all chunks must be returned, and this assertion
+		   checks for leaks */
+		assert(n_allocated.load(std::memory_order_relaxed) == 0);
+	}
 
 #ifndef NDEBUG
 	/**
 	 * Check whether the buffer is empty.
 	 *
-	 * This call is not protected with the #mutex, and may only be
-	 * used while this object is inaccessible to other threads.
+	 * This call may only be used while this object is
+	 * inaccessible to other threads.
 	 */
 	bool IsEmptyUnsafe() const {
-		return buffer.empty();
+		return n_allocated.load(std::memory_order_relaxed) == 0;
 	}
 #endif
 
 	bool IsFull() const noexcept {
-		const std::scoped_lock protect{mutex};
-		return buffer.IsFull();
+		return n_allocated.load(std::memory_order_relaxed) >= GetSize();
 	}
 
 	/**
@@ -49,22 +116,27 @@ public:
 	 */
 	[[gnu::pure]]
 	unsigned GetSize() const noexcept {
-		return buffer.GetCapacity();
+		return n_chunks;
+	}
+
+	/**
+	 * Returns the number of data bytes which fit into one chunk.
+	 */
+	std::size_t GetChunkDataSize() const noexcept {
+		return chunk_size - sizeof(MusicChunk);
 	}
 
 	void PopulateMemory() noexcept {
-		buffer.PopulateMemory();
+		memory.Populate();
 	}
 
 	/**
 	 * Give all memory allocations back to the kernel.
 	 *
-	 * This call is not protected with the #mutex, and may only be
-	 * used while this object is inaccessible to other threads.
+	 * This call may only be used while this object is
+	 * inaccessible to other threads.
 	 */
-	void DiscardMemory() noexcept {
-		buffer.DiscardMemory();
-	}
+	void DiscardMemory() noexcept;
 
 	/**
 	 * Allocates a chunk from the buffer.  When it is not used anymore,
@@ -80,4 +152,9 @@ public:
 	 * Allocate() then.
 	 */
 	void Return(MusicChunk *chunk) noexcept;
+
+private:
+	MusicChunk *GetChunk(unsigned i) noexcept {
+		return reinterpret_cast<MusicChunk *>(&memory[i * chunk_size]);
+	}
 };
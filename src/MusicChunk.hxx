@@ -17,6 +17,10 @@
 #include <memory>
 #include <span>
 
+/**
+ * The default (and minimum) size of one #MusicChunk allocation,
+ * including the #MusicChunk object and its data buffer.
+ */
 static constexpr size_t CHUNK_SIZE = 4096;
 
 struct AudioFormat;
@@ -49,7 +53,7 @@ struct MusicChunkInfo {
 	float mix_ratio;
 
 	/** number of bytes stored in this chunk */
-	uint16_t length = 0;
+	uint32_t length = 0;
 
 	/** current bit rate of the source file */
 	uint16_t bit_rate;
@@ -97,10 +101,25 @@ struct MusicChunkInfo {
 /**
  * A chunk of music data.  Its format is defined by the
  * MusicPipe::Push() caller.
+ *
+ * The data (probably PCM) is stored right after this object; its
+ * size is chosen at runtime by the #MusicBuffer which allocates
+ * the chunk.
  */
 struct MusicChunk : MusicChunkInfo {
-	/** the data (probably PCM) */
-	std::byte data[CHUNK_SIZE - sizeof(MusicChunkInfo)];
+	/** the size of the data buffer in bytes */
+	const std::size_t capacity;
+
+	explicit MusicChunk(std::size_t _capacity) noexcept
+		:capacity(_capacity) {}
+
+	std::byte *GetData() noexcept {
+		return reinterpret_cast<std::byte *>(this + 1);
+	}
+
+	const std::byte *GetData() const noexcept {
+		return reinterpret_cast<const std::byte *>(this + 1);
+	}
 
 	/**
 	 * Prepares appending to the music chunk.  Returns a buffer
@@ -129,8 +148,8 @@ struct MusicChunk : MusicChunkInfo {
 	bool Expand(AudioFormat af, size_t length) noexcept;
 
 	std::span<const std::byte> ReadData() const noexcept {
-		return {data, length};
+		return {GetData(), length};
 	}
 };
 
-static_assert(sizeof(MusicChunk) == CHUNK_SIZE, "Wrong size");
+static_assert(sizeof(MusicChunk) < CHUNK_SIZE, "Wrong size");
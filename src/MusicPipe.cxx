@@ -32,7 +32,11 @@ MusicPipe::Shift() noexcept
 		assert(!chunk->IsEmpty());
 
 		head = std::move(chunk->next);
-		--size;
+		head_chunk.store(head.get(), std::memory_order_release);
+		/* no atomic read-modify-write needed, because
+		   #size is only modified while #mutex is locked */
+		size.store(size.load(std::memory_order_relaxed) - 1,
+			   std::memory_order_release);
 
 		if (head == nullptr) {
 			assert(size == 0);
@@ -80,5 +84,9 @@ MusicPipe::Push(MusicChunkPtr chunk) noexcept
 	*tail_r = std::move(chunk);
 	tail_r = &(*tail_r)->next;
 
-	++size;
+	if (head_chunk.load(std::memory_order_relaxed) == nullptr)
+		head_chunk.store(head.get(), std::memory_order_release);
+
+	size.store(size.load(std::memory_order_relaxed) + 1,
+		   std::memory_order_release);
 }
@@ -11,9 +11,14 @@
 #include "pcm/AudioFormat.hxx"
 #endif
 
+#include <atomic>
+
 /**
  * A queue of #MusicChunk objects.  One party appends chunks at the
  * tail, and the other consumes them from the head.
+ *
+ * Push() and Shift() are serialized with a mutex, but Peek() and
+ * GetSize() (which are called much more often) are lock-free.
  */
 class MusicPipe {
 	/** the first chunk */
@@ -22,8 +27,17 @@ class MusicPipe {
 	/** a pointer to the tail of the chunk */
 	MusicChunkPtr *tail_r = &head;
 
-	/** the current number of chunks */
-	unsigned size = 0;
+	/**
+	 * A copy of #head's pointer value which can be read without
+	 * locking the #mutex.
+	 */
+	std::atomic<const MusicChunk *> head_chunk{nullptr};
+
+	/**
+	 * The current number of chunks.  It is only modified while
+	 * the #mutex is locked, but may be read without it.
+	 */
+	std::atomic_uint size{0};
 
 	/** a mutex which protects #head and #tail_r */
 	mutable Mutex mutex;
@@ -61,8 +75,7 @@ public:
 	 */
 	[[gnu::pure]]
 	const MusicChunk *Peek() const noexcept {
-		const std::scoped_lock protect{mutex};
-		return head.get();
+		return head_chunk.load(std::memory_order_acquire);
 	}
 
 	/**
@@ -85,8 +98,7 @@ public:
 	 */
 	[[gnu::pure]]
 	unsigned GetSize() const noexcept {
-		const std::scoped_lock protect{mutex};
-		return size;
+		return size.load(std::memory_order_acquire);
 	}
 
 	[[gnu::pure]]
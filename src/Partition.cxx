@@ -43,27 +43,30 @@ Partition::BeginShutdown() noexcept
 	listener.reset();
 }
 
-static void
-PrefetchSong(InputCacheManager &cache, const char *uri) noexcept
+/**
+ * @return false if the song does not fit into the budget
+ */
+static bool
+PrefetchSong(InputCacheManager &cache, const char *uri,
+	     std::size_t &budget) noexcept
 {
-	if (cache.Contains(uri))
-		return;
-
 	FmtDebug(cache_domain, "Prefetch {:?}", uri);
 
 	try {
-		cache.Prefetch(uri);
+		return cache.Prefetch(uri, budget);
 	} catch (...) {
 		FmtError(cache_domain,
 			 "Prefetch {:?} failed: {}",
 			 uri, std::current_exception());
+		return true;
 	}
 }
 
-static void
-PrefetchSong(InputCacheManager &cache, const DetachedSong &song) noexcept
+static bool
+PrefetchSong(InputCacheManager &cache, const DetachedSong &song,
+	     std::size_t &budget) noexcept
 {
-	PrefetchSong(cache, song.GetURI());
+	return PrefetchSong(cache, song.GetURI(), budget);
 }
 
 inline void
@@ -74,11 +77,24 @@ Partition::PrefetchQueue() noexcept
 
 	auto &cache = *instance.input_cache;
 
-	int next = playlist.GetNextPosition();
-	if (next >= 0)
-		PrefetchSong(cache, playlist.queue.Get(next));
+	const auto &queue = playlist.queue;
+	const int current = playlist.current;
+	if (current < 0)
+		return;
+
+	/* stop when the next song would evict one which was
+	   prefetched (or refreshed) by this loop */
+	std::size_t budget = cache.GetPrefetchBudget();
+
+	int order = current;
+	for (unsigned n = cache.GetPrefetchCount(); n > 0; --n) {
+		order = queue.GetNextOrder(order);
+		if (order < 0 || order == current)
+			break;
 
-	// TODO: prefetch more songs
+		if (!PrefetchSong(cache, queue.GetOrder(order), budget))
+			break;
+	}
 }
 
 void
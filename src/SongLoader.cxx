@@ -6,12 +6,18 @@
 #include "Partition.hxx"
 #include "client/IClient.hxx"
 #include "db/DatabaseSong.hxx"
+#include "db/Interface.hxx"
 #include "storage/StorageInterface.hxx"
 #include "song/DetachedSong.hxx"
 #include "PlaylistError.hxx"
+#include "thread/Thread.hxx"
 #include "config.h"
 
+#include <algorithm> // for std::min()
+#include <atomic>
 #include <cassert>
+#include <list>
+#include <string>
 #include <utility> // for std::unreachable()
 
 #ifdef ENABLE_DATABASE
@@ -89,3 +95,161 @@ SongLoader::LoadSong(const char *uri_utf8) const
 					   );
 	return LoadSong(located_uri);
 }
+
+namespace {
+
+/**
+ * A local file (not in the database) which shall be scanned by
+ * SongLoader::LoadSongs().
+ */
+struct FileScanJob {
+	std::optional<DetachedSong> &result;
+
+	AllocatedPath path_fs;
+
+	std::string path_utf8;
+
+	void Run() noexcept {
+		try {
+			DetachedSong song(path_utf8);
+			if (song.LoadFile(path_fs))
+				result.emplace(std::move(song));
+		} catch (...) {
+			/* leave the result empty; the caller may
+			   retry with SongLoader::LoadSong() to obtain
+			   the error */
+		}
+	}
+};
+
+/**
+ * Scan several local files concurrently.  The calling thread
+ * participates, and a few worker threads are launched to help it.
+ */
+class ParallelFileScanner {
+	static constexpr std::size_t MAX_THREADS = 4;
+
+	std::span<FileScanJob> jobs;
+
+	std::atomic_size_t next{0};
+
+public:
+	explicit ParallelFileScanner(std::span<FileScanJob> _jobs) noexcept
+		:jobs(_jobs) {}
+
+	void Run() noexcept {
+		std::list<Thread> threads;
+
+		const std::size_t n_threads = std::min(jobs.size(), MAX_THREADS);
+		for (std::size_t i = 1; i < n_threads; ++i) {
+			auto &thread = threads.emplace_back(BIND_THIS_METHOD(RunJobs));
+			try {
+				thread.Start();
+			} catch (...) {
+				/* not fatal, the remaining threads
+				   will do the work */
+				threads.pop_back();
+				break;
+			}
+		}
+
+		RunJobs();
+
+		for (auto &thread : threads)
+			thread.Join();
+	}
+
+private:
+	void RunJobs() noexcept {
+		std::size_t i;
+		while ((i = next.fetch_add(1, std::memory_order_relaxed)) < jobs.size())
+			jobs[i].Run();
+	}
+};
+
+} // anonymous namespace
+
+std::vector<std::optional<DetachedSong>>
+SongLoader::LoadSongs(std::span<const char *const> uris) const noexcept
+{
+	std::vector<std::optional<DetachedSong>> result(uris.size());
+
+#ifdef ENABLE_DATABASE
+	/* database songs are collected here and looked up all at
+	   once */
+	std::vector<std::string> db_uris;
+	std::vector<std::size_t> db_indexes;
+#endif
+
+	std::vector<FileScanJob> file_jobs;
+
+	for (std::size_t i = 0; i < uris.size(); ++i) {
+		try {
+			auto located_uri = LocateUri(UriPluginKind::INPUT,
+						     uris[i], client
+#ifdef ENABLE_DATABASE
+						     , storage
+#endif
+						     );
+
+			switch (located_uri.type) {
+			case LocatedUri::Type::ABSOLUTE:
+				result[i].emplace(located_uri.canonical_uri);
+				break;
+
+			case LocatedUri::Type::RELATIVE:
+#ifdef ENABLE_DATABASE
+				db_uris.emplace_back(located_uri.canonical_uri);
+				db_indexes.push_back(i);
+#endif
+				break;
+
+			case LocatedUri::Type::PATH:
+#ifdef ENABLE_DATABASE
+				if (storage != nullptr) {
+					const auto suffix = storage->MapToRelativeUTF8(located_uri.canonical_uri);
+					if (suffix.data() != nullptr) {
+						/* this path was relative to the
+						   music directory - obtain it from
+						   the database */
+						db_uris.emplace_back(suffix);
+						db_indexes.push_back(i);
+						break;
+					}
+				}
+#endif
+
+				file_jobs.push_back({
+					result[i],
+					std::move(located_uri.path),
+					located_uri.canonical_uri,
+				});
+				break;
+			}
+		} catch (...) {
+			/* leave this element empty */
+		}
+	}
+
+#ifdef ENABLE_DATABASE
+	if (db != nullptr && !db_uris.empty()) {
+		const std::vector<std::string_view> views(db_uris.begin(),
+							  db_uris.end());
+
+		try {
+			db->GetSongs(views, [this, &result, &db_indexes](std::size_t i,
+									  const LightSong &song){
+				result[db_indexes[i]].emplace(DatabaseDetachSong(storage, song));
+			});
+		} catch (...) {
+			/* the elements which have not yet been
+			   loaded remain empty */
+		}
+	}
+#endif
+
+	if (!file_jobs.empty())
+		ParallelFileScanner{file_jobs}.Run();
+
+	return result;
+}
@@ -6,6 +6,9 @@
 #include "db/Features.hxx" // for ENABLE_DATABASE
 
 #include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
 
 class IClient;
 class Database;
@@ -57,6 +60,19 @@ public:
 	[[gnu::nonnull]]
 	DetachedSong LoadSong(const char *uri_utf8) const;
 
+	/**
+	 * Load many songs at once.  Songs from the database are
+	 * looked up with one Database::GetSongs() call, and local
+	 * files which are not in the database are scanned
+	 * concurrently.
+	 *
+	 * @return one element for each URI; std::nullopt if the URI
+	 * could not be loaded as a song (e.g. because it does not
+	 * exist or because it is a directory); the caller may use
+	 * LoadSong() to obtain the error
+	 */
+	std::vector<std::optional<DetachedSong>> LoadSongs(std::span<const char *const> uris) const noexcept;
+
 private:
 	[[gnu::nonnull]]
 	DetachedSong LoadFromDatabase(const char *uri) const;
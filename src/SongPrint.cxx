@@ -2,11 +2,13 @@
 // Copyright The Music Player Daemon Project
 
 #include "SongPrint.hxx"
+#include "SongRecord.hxx"
 #include "song/LightSong.hxx"
 #include "song/DetachedSong.hxx"
 #include "TimePrint.hxx"
 #include "TagPrint.hxx"
 #include "client/Response.hxx"
+#include "pcm/AudioFormat.hxx"
 #include "fs/Traits.hxx"
 #include "lib/fmt/AudioFormatFormatter.hxx"
 #include "time/ChronoUtil.hxx"
@@ -67,9 +69,100 @@ PrintRange(Response &r, SongTime start_time, SongTime end_time) noexcept
 		      start_ms % 1000);
 }
 
+static void
+song_record_add_uri(SongRecordBuilder &record,
+		    const char *uri, bool base) noexcept
+{
+	std::string allocated;
+
+	if (base) {
+		uri = PathTraitsUTF8::GetBase(uri);
+	} else {
+		allocated = uri_remove_auth(uri);
+		if (!allocated.empty())
+			uri = allocated.c_str();
+	}
+
+	record.Add(SongRecordField::URI, uri);
+}
+
+static void
+song_record_add_time(SongRecordBuilder &record, SongRecordField field,
+		     std::chrono::system_clock::time_point t) noexcept
+{
+	if (IsNegative(t))
+		return;
+
+	const auto s = std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch());
+	record.Add(field, static_cast<uint_least64_t>(s.count()));
+}
+
+static void
+song_record_add_details(SongRecordBuilder &record, const Response &r,
+			SongTime start_time, SongTime end_time,
+			std::chrono::system_clock::time_point mtime,
+			std::chrono::system_clock::time_point added,
+			const AudioFormat &audio_format,
+			const Tag &tag, SignedSongTime duration) noexcept
+{
+	if (start_time.ToMS() > 0 || end_time.ToMS() > 0)
+		record.Add(SongRecordField::RANGE,
+			   start_time.ToMS(), end_time.ToMS());
+
+	song_record_add_time(record, SongRecordField::LAST_MODIFIED, mtime);
+	song_record_add_time(record, SongRecordField::ADDED, added);
+
+	if (audio_format.IsDefined())
+		record.Add(SongRecordField::FORMAT,
+			   fmt::format("{}", audio_format));
+
+	tag_record_add_values(record, r, tag);
+
+	if (!duration.IsNegative())
+		record.Add(SongRecordField::DURATION,
+			   static_cast<uint_least64_t>(duration.ToMS()));
+}
+
+static void
+song_record_add(SongRecordBuilder &record, const Response &r,
+		const LightSong &song, bool base) noexcept
+{
+	if (!base && song.directory != nullptr)
+		record.Add(SongRecordField::URI,
+			   fmt::format("{}/{}", song.directory, song.uri));
+	else
+		song_record_add_uri(record, song.uri, base);
+
+	song_record_add_details(record, r,
+				song.start_time, song.end_time,
+				song.mtime, song.added,
+				song.audio_format, song.tag,
+				song.GetDuration());
+}
+
+void
+song_record_add(SongRecordBuilder &record, const Response &r,
+		const DetachedSong &song, bool base) noexcept
+{
+	song_record_add_uri(record, song.GetURI(), base);
+
+	song_record_add_details(record, r,
+				song.GetStartTime(), song.GetEndTime(),
+				song.GetLastModified(), song.GetAdded(),
+				song.GetAudioFormat(), song.GetTag(),
+				song.GetDuration());
+}
+
 void
 song_print_info(Response &r, const LightSong &song, bool base) noexcept
 {
+	if (r.ProtocolFeatureEnabled(PF_BINARY_SONGS)) {
+		SongRecordBuilder record;
+		song_record_add(record, r, song, base);
+		record.Send(r);
+		return;
+	}
+
 	song_print_uri(r, song, base);
 
 	PrintRange(r, song.start_time, song.end_time);
@@ -96,6 +189,13 @@ song_print_info(Response &r, const LightSong &song, bool base) noexcept
 void
 song_print_info(Response &r, const DetachedSong &song, bool base) noexcept
 {
+	if (r.ProtocolFeatureEnabled(PF_BINARY_SONGS)) {
+		SongRecordBuilder record;
+		song_record_add(record, r, song, base);
+		record.Send(r);
+		return;
+	}
+
 	song_print_uri(r, song, base);
 
 	PrintRange(r, song.GetStartTime(), song.GetEndTime());
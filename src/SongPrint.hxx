@@ -7,6 +7,16 @@
 struct LightSong;
 class DetachedSong;
 class Response;
+class SongRecordBuilder;
+
+/**
+ * Add the song's attributes to a binary record (for clients which
+ * have enabled the protocol feature "binary_songs").  This is the
+ * binary equivalent of song_print_info().
+ */
+void
+song_record_add(SongRecordBuilder &record, const Response &r,
+		const DetachedSong &song, bool base=false) noexcept;
 
 void
 song_print_info(Response &r, const DetachedSong &song,
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "SongRecord.hxx"
+#include "client/Response.hxx"
+#include "tag/Type.hxx"
+
+#include <array>
+#include <cassert>
+
+/**
+ * The field codes of all tags.  These are part of the protocol and
+ * must never change; a new tag gets the next unused code below 0x80
+ * (see doc/protocol.rst).
+ */
+static constexpr struct {
+	TagType type;
+	uint8_t code;
+} song_record_tag_codes_init[] = {
+	{TAG_ARTIST, 0x00},
+	{TAG_ARTIST_SORT, 0x01},
+	{TAG_ALBUM, 0x02},
+	{TAG_ALBUM_SORT, 0x03},
+	{TAG_ALBUM_ARTIST, 0x04},
+	{TAG_ALBUM_ARTIST_SORT, 0x05},
+	{TAG_TITLE, 0x06},
+	{TAG_TITLE_SORT, 0x07},
+	{TAG_TRACK, 0x08},
+	{TAG_NAME, 0x09},
+	{TAG_GENRE, 0x0a},
+	{TAG_MOOD, 0x0b},
+	{TAG_DATE, 0x0c},
+	{TAG_ORIGINAL_DATE, 0x0d},
+	{TAG_COMPOSER, 0x0e},
+	{TAG_COMPOSERSORT, 0x0f},
+	{TAG_PERFORMER, 0x10},
+	{TAG_CONDUCTOR, 0x11},
+	{TAG_WORK, 0x12},
+	{TAG_MOVEMENT, 0x13},
+	{TAG_MOVEMENTNUMBER, 0x14},
+	{TAG_SHOWMOVEMENT, 0x15},
+	{TAG_ENSEMBLE, 0x16},
+	{TAG_LOCATION, 0x17},
+	{TAG_GROUPING, 0x18},
+	{TAG_COMMENT, 0x19},
+	{TAG_DISC, 0x1a},
+	{TAG_LABEL, 0x1b},
+	{TAG_MUSICBRAINZ_ARTISTID, 0x1c},
+	{TAG_MUSICBRAINZ_ALBUMID, 0x1d},
+	{TAG_MUSICBRAINZ_ALBUMARTISTID, 0x1e},
+	{TAG_MUSICBRAINZ_TRACKID, 0x1f},
+	{TAG_MUSICBRAINZ_RELEASETRACKID, 0x20},
+	{TAG_MUSICBRAINZ_WORKID, 0x21},
+	{TAG_MUSICBRAINZ_RELEASEGROUPID, 0x22},
+};
+
+/**
+ * Convert #song_record_tag_codes_init to an array indexed by
+ * #TagType at compile time.
+ */
+static constexpr auto
+MakeSongRecordTagCodes() noexcept
+{
+	std::array<uint8_t, TAG_NUM_OF_ITEM_TYPES> result{};
+	std::array<bool, TAG_NUM_OF_ITEM_TYPES> found{};
+	std::array<bool, 0x80> used{};
+
+	static_assert(std::size(song_record_tag_codes_init) == result.size());
+
+	for (const auto &i : song_record_tag_codes_init) {
+		/* no duplicates allowed */
+		assert(!found[i.type]);
+		assert(i.code < used.size());
+		assert(!used[i.code]);
+
+		found[i.type] = true;
+		used[i.code] = true;
+		result[i.type] = i.code;
+	}
+
+	return result;
+}
+
+static constexpr auto song_record_tag_codes = MakeSongRecordTagCodes();
+
+/**
+ * The maximum size of an encoded varint.
+ */
+static constexpr std::size_t MAX_VARINT_SIZE = 10;
+
+/**
+ * Encode an unsigned LEB128 varint.
+ *
+ * @return the number of bytes written
+ */
+static std::size_t
+EncodeVarint(char *dest, uint_least64_t value) noexcept
+{
+	std::size_t n = 0;
+
+	while (value >= 0x80) {
+		dest[n++] = static_cast<char>((value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+
+	dest[n++] = static_cast<char>(value);
+	return n;
+}
+
+inline void
+SongRecordBuilder::AddRaw(uint8_t code, std::string_view value) noexcept
+{
+	char length[MAX_VARINT_SIZE];
+
+	buffer.push_back(static_cast<char>(code));
+	buffer.append(length, EncodeVarint(length, value.size()));
+	buffer.append(value);
+}
+
+void
+SongRecordBuilder::Add(TagType type, std::string_view value) noexcept
+{
+	AddRaw(song_record_tag_codes[type], value);
+}
+
+void
+SongRecordBuilder::Add(SongRecordField field, uint_least64_t value) noexcept
+{
+	char tmp[MAX_VARINT_SIZE];
+	const std::size_t n = EncodeVarint(tmp, value);
+	AddRaw(static_cast<uint8_t>(field), {tmp, n});
+}
+
+void
+SongRecordBuilder::Add(SongRecordField field,
+		       uint_least64_t a, uint_least64_t b) noexcept
+{
+	char tmp[2 * MAX_VARINT_SIZE];
+	std::size_t n = EncodeVarint(tmp, a);
+	n += EncodeVarint(tmp + n, b);
+	AddRaw(static_cast<uint8_t>(field), {tmp, n});
+}
+
+bool
+SongRecordBuilder::Send(Response &r) const noexcept
+{
+	return r.Fmt("record: {}\n", buffer.size()) &&
+		r.Write(buffer.data(), buffer.size()) &&
+		r.Write("\n");
+}
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+enum TagType : uint8_t;
+class Response;
+
+/**
+ * Field codes in a binary song record (protocol feature
+ * "binary_songs").  Codes below 0x80 are tags; they are assigned by
+ * a fixed table in SongRecord.cxx which does not depend on the
+ * #TagType numbering.
+ */
+enum class SongRecordField : uint8_t {
+	/**
+	 * The song URI (string); this is always the first field.
+	 */
+	URI = 0x80,
+
+	/**
+	 * Start and end time in milliseconds (two varints); the end
+	 * is 0 if the song plays until the end of the file.
+	 */
+	RANGE,
+
+	/**
+	 * Seconds since the epoch (varint).
+	 */
+	LAST_MODIFIED,
+
+	/**
+	 * Seconds since the epoch (varint).
+	 */
+	ADDED,
+
+	/**
+	 * The audio format (string).
+	 */
+	FORMAT,
+
+	/**
+	 * The duration in milliseconds (varint).
+	 */
+	DURATION,
+
+	/**
+	 * The position in the queue (varint).
+	 */
+	POS,
+
+	/**
+	 * The queue song id (varint).
+	 */
+	ID,
+
+	/**
+	 * The queue priority (varint).
+	 */
+	PRIO,
+};
+
+/**
+ * Builds one binary song record: a sequence of fields, each
+ * consisting of a one-byte field code, the value length (varint) and
+ * the value.  Integers are encoded as unsigned LEB128 varints.
+ *
+ * On the wire, the record is sent as a "record: SIZE" line, followed
+ * by SIZE bytes and a newline character, just like binary responses.
+ */
+class SongRecordBuilder {
+	std::string buffer;
+
+public:
+	std::string_view GetData() const noexcept {
+		return buffer;
+	}
+
+	void Add(SongRecordField field, std::string_view value) noexcept {
+		AddRaw(static_cast<uint8_t>(field), value);
+	}
+
+	void Add(TagType type, std::string_view value) noexcept;
+
+	void Add(SongRecordField field, uint_least64_t value) noexcept;
+
+	void Add(SongRecordField field,
+		 uint_least64_t a, uint_least64_t b) noexcept;
+
+	/**
+	 * Send the record to the client.
+	 *
+	 * @return true on success
+	 */
+	bool Send(Response &r) const noexcept;
+
+private:
+	void AddRaw(uint8_t code, std::string_view value) noexcept;
+};
@@ -10,6 +10,9 @@
 #include "db/Selection.hxx"
 #include "db/Interface.hxx"
 #include "db/Stats.hxx"
+#include "db/cache/QueryCache.hxx"
+#include "db/cache/PictureCache.hxx"
+#include "input/cache/Manager.hxx"
 #include "Log.hxx"
 #include "time/ChronoUtil.hxx"
 
@@ -117,5 +120,20 @@ stats_print(Response &r, const Partition &partition)
 	const Database *db = partition.instance.GetDatabase();
 	if (db != nullptr)
 		db_stats_print(r, *db);
+
+	if (const auto *cache = partition.instance.query_cache.get())
+		r.Fmt("query_cache_hits: {}\n"
+		      "query_cache_misses: {}\n",
+		      cache->GetHits(), cache->GetMisses());
+
+	if (const auto *cache = partition.instance.picture_cache.get())
+		r.Fmt("picture_cache_hits: {}\n"
+		      "picture_cache_misses: {}\n",
+		      cache->GetHits(), cache->GetMisses());
 #endif
+
+	if (const auto *cache = partition.instance.input_cache.get())
+		r.Fmt("input_cache_hits: {}\n"
+		      "input_cache_misses: {}\n",
+		      cache->GetHits(), cache->GetMisses());
 }
@@ -5,6 +5,7 @@
 #include "tag/Names.hxx"
 #include "tag/Tag.hxx"
 #include "tag/Settings.hxx"
+#include "SongRecord.hxx"
 #include "client/Response.hxx"
 
 #include <fmt/format.h>
@@ -48,6 +49,16 @@ tag_print_values(Response &r, const Tag &tag) noexcept
 			tag_print(r, i.type, i.value);
 }
 
+void
+tag_record_add_values(SongRecordBuilder &record, const Response &r,
+		      const Tag &tag) noexcept
+{
+	const auto tag_mask = r.GetTagMask();
+	for (const auto &i : tag)
+		if (tag_mask.Test(i.type))
+			record.Add(i.type, i.value);
+}
+
 void
 tag_print(Response &r, const Tag &tag) noexcept
 {
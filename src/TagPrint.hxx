@@ -11,6 +11,7 @@ enum TagType : uint8_t;
 
 struct Tag;
 class Response;
+class SongRecordBuilder;
 
 void
 tag_print_types(Response &response) noexcept;
@@ -30,4 +31,12 @@ tag_print_values(Response &response, const Tag &tag) noexcept;
 void
 tag_print(Response &response, const Tag &tag) noexcept;
 
+/**
+ * Like tag_print_values(), but add the values to a binary song
+ * record.
+ */
+void
+tag_record_add_values(SongRecordBuilder &record, const Response &response,
+		      const Tag &tag) noexcept;
+
 #endif
@@ -26,6 +26,14 @@ public:
 	 * #Client's #EventLoop thread.
 	 */
 	virtual void Cancel() noexcept = 0;
+
+	/**
+	 * The client's output buffer has been sent completely to the
+	 * socket.  This is a good time to generate more of the
+	 * response.  It will be called from the #Client's #EventLoop
+	 * thread and must not send anything synchronously.
+	 */
+	virtual void OnClientOutputEmpty() noexcept {}
 };
 
 #endif
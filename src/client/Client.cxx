@@ -9,10 +9,14 @@
 #include "protocol/IdleFlags.hxx"
 #include "config.h"
 
+#ifdef ENABLE_ZLIB
+#include "Compressor.hxx"
+#endif
+
 Client::~Client() noexcept
 {
-	if (FullyBufferedSocket::IsDefined())
-		FullyBufferedSocket::Close();
+	if (socket->IsDefined())
+		socket->Close();
 
 	if (background_command) {
 		background_command->Cancel();
@@ -41,11 +45,42 @@ Client::OnBackgroundCommandFinished() noexcept
 
 	/* just in case OnSocketInput() has returned
 	   InputResult::PAUSE meanwhile */
-	ResumeInput();
+	socket->ResumeInput();
 
 	timeout_event.Schedule(client_timeout);
 }
 
+std::unique_ptr<BackgroundCommand>
+Client::ReleaseBackgroundCommand() noexcept
+{
+	assert(background_command);
+
+	return std::move(background_command);
+}
+
+void
+Client::OnSocketOutputEmpty() noexcept
+{
+	if (background_command)
+		background_command->OnClientOutputEmpty();
+}
+
+void
+Client::SetProtocolFeatures(ProtocolFeature features, bool enable) noexcept
+{
+	if (enable) {
+		if (features.Test(PF_IDLE_PAYLOAD) &&
+		    !protocol_feature.Test(PF_IDLE_PAYLOAD))
+			/* the client is expected to know the current
+			   queue; the next "idle" response reports
+			   changes relative to it */
+			idle_playlist_version = GetPlaylist().GetVersion();
+
+		protocol_feature.Set(features);
+	} else
+		protocol_feature.Unset(features);
+}
+
 void
 Client::SetPartition(Partition &new_partition) noexcept
 {
@@ -56,6 +91,10 @@ Client::SetPartition(Partition &new_partition) noexcept
 	partition = &new_partition;
 	partition->clients.push_back(*this);
 
+	/* queue versions of different partitions cannot be
+	   compared */
+	idle_playlist_version = 0;
+
 	/* set idle flags for those subsystems which are specific to
 	   the current partition to force the client to reload its
 	   state */
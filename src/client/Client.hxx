@@ -10,11 +10,14 @@
 #include "command/CommandResult.hxx"
 #include "command/CommandListBuilder.hxx"
 #include "db/Features.hxx" // for ENABLE_DATABASE
+#include "db/cache/PictureCache.hxx"
 #include "input/LastInputStream.hxx"
 #include "tag/Mask.hxx"
-#include "event/FullyBufferedSocket.hxx"
+#include "Socket.hxx"
 #include "event/CoarseTimerEvent.hxx"
+#include "event/DeferEvent.hxx"
 #include "util/IntrusiveList.hxx"
+#include "config.h" // for ENABLE_ZLIB
 
 #include <cstddef>
 #include <list>
@@ -34,15 +37,25 @@ struct playlist;
 class Database;
 class Storage;
 class BackgroundCommand;
+class ResponseCompressor;
+class CommandListContinuation;
+class ClientIOThread;
 
 class Client final
-	: public IClient, FullyBufferedSocket
+	: public IClient, ClientSocketHandler
 {
 	friend struct ClientPerPartitionListHook;
 	friend class ClientList;
+	friend class CommandListContinuation;
 
 	const std::string name;
 
+	/**
+	 * The connection to the client; either a
+	 * #DirectClientSocket or a #ThreadedClientSocket.
+	 */
+	std::unique_ptr<ClientSocket> socket;
+
 	IntrusiveListHook<> list_siblings, partition_siblings;
 
 	CoarseTimerEvent timeout_event;
@@ -59,6 +72,9 @@ class Client final
 	/** is this client waiting for an "idle" response? */
 	bool idle_waiting = false;
 
+	/** is this client currently executing a command list? */
+	bool in_command_list = false;
+
 	/** idle flags pending on this client, to be sent as soon as
 	    the client enters "idle" */
 	unsigned idle_flags = 0;
@@ -66,6 +82,13 @@ class Client final
 	/** idle flags that the client wants to receive */
 	unsigned idle_subscriptions;
 
+	/**
+	 * The queue version which was last reported to this client
+	 * in an "idle" response.  Only used if #PF_IDLE_PAYLOAD is
+	 * enabled.
+	 */
+	uint32_t idle_playlist_version = 0;
+
 public:
 	// TODO: make this attribute "private"
 	/**
@@ -86,6 +109,14 @@ public:
 	 */
 	LastInputStream last_album_art;
 
+#ifdef ENABLE_DATABASE
+	/**
+	 * Collects the "albumart" file being transmitted to this
+	 * client chunk by chunk, to add it to the #PictureCache.
+	 */
+	PictureCacheFiller album_art_filler;
+#endif
+
 private:
 	static constexpr size_t MAX_SUBSCRIPTIONS = 16;
 
@@ -125,20 +156,56 @@ private:
 	 */
 	StringNormalization string_normalization = StringNormalization::None();
 
+#ifdef ENABLE_ZLIB
+	/**
+	 * Compresses all output while the #PF_GZIP protocol feature
+	 * is enabled.  It is created and destroyed by
+	 * FinishResponse(), i.e. changing the feature affects only
+	 * the following responses.
+	 */
+	std::unique_ptr<ResponseCompressor> compressor;
+
+	/**
+	 * Sends the data buffered in #compressor at the end of this
+	 * event loop iteration, for output which is not generated
+	 * by OnSocketInput() (e.g. by a #BackgroundCommand).
+	 */
+	DeferEvent compressor_flush_event;
+#endif
+
 public:
+	/**
+	 * Throws on error.
+	 *
+	 * @param io_thread if not nullptr, then the socket I/O is
+	 * done in this thread (see #ThreadedClientSocket)
+	 */
 	Client(EventLoop &loop, Partition &partition,
-	       UniqueSocketDescriptor fd, int uid,
+	       UniqueSocketDescriptor &&fd, int uid,
 	       unsigned _permission,
-	       std::string &&_name) noexcept;
+	       std::string &&_name,
+	       ClientIOThread *io_thread);
 
 	~Client() noexcept;
 
-	using FullyBufferedSocket::GetEventLoop;
-	using FullyBufferedSocket::GetOutputMaxSize;
+	auto &GetEventLoop() const noexcept {
+		return timeout_event.GetEventLoop();
+	}
+
+	std::size_t GetOutputMaxSize() const noexcept {
+		return socket->GetOutputMaxSize();
+	}
+
+	/**
+	 * Returns the number of bytes which are waiting to be sent
+	 * to the client.
+	 */
+	[[gnu::pure]]
+	std::size_t GetOutputSize() const noexcept;
 
 	[[gnu::pure]]
 	bool IsExpired() const noexcept {
-		return !FullyBufferedSocket::IsDefined();
+		return !socket->IsDefined();
 	}
 
 	void Close() noexcept;
@@ -177,22 +244,27 @@ public:
 		return protocol_feature;
 	}
 
-	void SetProtocolFeatures(ProtocolFeature features, bool enable) noexcept {
-		if (enable)
-			protocol_feature.Set(features);
-		else
-			protocol_feature.Unset(features);
-	}
+	void SetProtocolFeatures(ProtocolFeature features, bool enable) noexcept;
 
 	void AllProtocolFeatures() noexcept {
 		protocol_feature.SetAll();
+
+#ifdef ENABLE_ZLIB
+		/* compression changes the response format and must
+		   be enabled explicitly */
+		protocol_feature.Unset(PF_GZIP);
+#endif
+
+		/* same for binary song records and idle payloads */
+		protocol_feature.Unset(PF_BINARY_SONGS);
+		protocol_feature.Unset(PF_IDLE_PAYLOAD);
 	}
 
 	void ClearProtocolFeatures() noexcept {
 		protocol_feature.Clear();
 	}
 
-	bool ProtocolFeatureEnabled(enum ProtocolFeatureType value) noexcept {
+	bool ProtocolFeatureEnabled(enum ProtocolFeatureType value) const noexcept {
 		return protocol_feature.Test(value);
 	}
 
@@ -226,6 +298,16 @@ public:
 	void IdleAdd(unsigned flags) noexcept;
 	bool IdleWait(unsigned flags) noexcept;
 
+	/**
+	 * Is a command list being executed currently?  While this is
+	 * the case, commands must not return
+	 * #CommandResult::BACKGROUND, because the rest of the command
+	 * list would be discarded.
+	 */
+	bool IsInCommandList() const noexcept {
+		return in_command_list;
+	}
+
 	/**
 	 * Called by a command handler to defer execution to a
 	 * #BackgroundCommand.
@@ -239,6 +321,15 @@ public:
 	 */
 	void OnBackgroundCommandFinished() noexcept;
 
+	/**
+	 * Temporarily detach the current #BackgroundCommand from this
+	 * client, to protect it from being deleted synchronously by
+	 * SetExpired() while it is running.  Afterwards, the caller
+	 * shall return it with SetBackgroundCommand() (unless the
+	 * client has expired meanwhile).
+	 */
+	std::unique_ptr<BackgroundCommand> ReleaseBackgroundCommand() noexcept;
+
 	enum class SubscribeResult {
 		/** success */
 		OK,
@@ -307,12 +398,49 @@ private:
 	CommandResult ProcessCommandList(bool list_ok,
 					 std::list<std::string> &&list) noexcept;
 
+	/**
+	 * Execute commands from the front of the list (and remove
+	 * them) until the list is empty, a command does not return
+	 * #CommandResult::OK or the time slice is over.
+	 *
+	 * @param n the index of the first command in the list; will
+	 * be updated
+	 * @param suspended set to true if the time slice is over and
+	 * the list is not yet empty
+	 */
+	CommandResult ExecuteCommandList(std::list<std::string> &list,
+					 unsigned &n, bool list_ok,
+					 bool &suspended) noexcept;
+
+	/**
+	 * Continue a command list which was suspended by
+	 * ProcessCommandList().
+	 */
+	void ResumeCommandList(CommandListContinuation &c) noexcept;
+
 	CommandResult ProcessLine(char *line) noexcept;
 
-	/* virtual methods from class BufferedSocket */
+	/**
+	 * Called after a command (or a command list) has been
+	 * processed.  Sends the compressed frame and applies changes
+	 * to the #PF_GZIP protocol feature.
+	 */
+	void FinishResponse() noexcept;
+
+#ifdef ENABLE_ZLIB
+	bool WriteCompressed(std::span<const std::byte> src) noexcept;
+
+	/**
+	 * Send the data buffered in #compressor as one frame.
+	 */
+	void FlushCompressor() noexcept;
+#endif
+
+	/* virtual methods from class ClientSocketHandler */
 	InputResult OnSocketInput(std::span<std::byte> src) noexcept override;
 	void OnSocketError(std::exception_ptr ep) noexcept override;
 	void OnSocketClosed() noexcept override;
+	void OnSocketOutputEmpty() noexcept override;
 
 	/* callback for TimerEvent */
 	void OnTimeout() noexcept;
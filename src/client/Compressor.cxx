@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "Compressor.hxx"
+#include "util/SpanCast.hxx"
+
+#include <fmt/format.h>
+
+void
+ResponseCompressor::Sink::Write(std::span<const std::byte> src)
+{
+	value.append(ToStringView(src));
+}
+
+ResponseCompressor::ResponseCompressor()
+	:gzip(compressed)
+{
+}
+
+void
+ResponseCompressor::Write(std::span<const std::byte> src)
+{
+	if (!in_gzip) {
+		if (pending.size() + src.size() <= SMALL_FRAME) {
+			pending.append(ToStringView(src));
+			return;
+		}
+
+		/* the frame is too large to be sent uncompressed;
+		   start compressing */
+		in_gzip = true;
+		gzip.Write(AsBytes(pending));
+		pending.clear();
+	}
+
+	gzip.Write(src);
+}
+
+std::string_view
+ResponseCompressor::Flush()
+{
+	frame.clear();
+
+	if (!in_gzip) {
+		frame.swap(pending);
+		return frame;
+	}
+
+	gzip.SyncFlush();
+	in_gzip = false;
+
+	fmt::format_to(std::back_inserter(frame), "gzip: {}\n",
+		       compressed.value.size());
+	frame.append(compressed.value);
+	frame.push_back('\n');
+	compressed.value.clear();
+
+	return frame;
+}
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "lib/zlib/GzipOutputStream.hxx"
+#include "io/OutputStream.hxx"
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+/**
+ * Compresses the output sent to a client which has enabled the
+ * "gzip" protocol feature.  All data is fed into one gzip stream
+ * until the feature is disabled (enabling it again creates a new
+ * instance with a new stream); Flush() completes a frame which can
+ * be decompressed by the client without waiting for more data.
+ *
+ * Each frame is sent as a "gzip: SIZE" line followed by SIZE bytes
+ * of compressed data and a newline, just like binary responses.
+ * Small frames are sent uncompressed, because the framing overhead
+ * would exceed the savings.
+ */
+class ResponseCompressor {
+	/**
+	 * Frames smaller than this are not compressed.
+	 */
+	static constexpr std::size_t SMALL_FRAME = 256;
+
+	class Sink final : public OutputStream {
+	public:
+		std::string value;
+
+		/* virtual methods from class OutputStream */
+		void Write(std::span<const std::byte> src) override;
+	};
+
+	/**
+	 * Receives compressed data from #gzip.
+	 */
+	Sink compressed;
+
+	GzipOutputStream gzip;
+
+	/**
+	 * Uncompressed data which has not yet been passed to #gzip,
+	 * because the frame may turn out to be small.
+	 */
+	std::string pending;
+
+	/**
+	 * The frame returned by the last Flush() call.
+	 */
+	std::string frame;
+
+	/**
+	 * Has data been passed to #gzip since the last Flush()?
+	 */
+	bool in_gzip = false;
+
+public:
+	/**
+	 * Throws #ZlibError on error.
+	 */
+	ResponseCompressor();
+
+	ResponseCompressor(const ResponseCompressor &) = delete;
+	ResponseCompressor &operator=(const ResponseCompressor &) = delete;
+
+	bool IsEmpty() const noexcept {
+		return pending.empty() && !in_gzip;
+	}
+
+	/**
+	 * Returns the number of bytes which are buffered inside this
+	 * object and will be sent with the next frame.
+	 */
+	std::size_t GetBufferedSize() const noexcept {
+		return pending.size() + compressed.value.size();
+	}
+
+	/**
+	 * Throws on error.
+	 */
+	void Write(std::span<const std::byte> src);
+
+	/**
+	 * Finish the current frame.
+	 *
+	 * Throws on error.
+	 *
+	 * @return the data to be sent to the client; it is valid
+	 * until the next call
+	 */
+	std::string_view Flush();
+};
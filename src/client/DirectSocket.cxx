@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "DirectSocket.hxx"
+
+DirectClientSocket::~DirectClientSocket() noexcept
+{
+	if (IsDefined())
+		Close();
+}
+
+BufferedSocket::InputResult
+DirectClientSocket::OnSocketInput(std::span<std::byte> src) noexcept
+{
+	switch (handler.OnSocketInput(src)) {
+	case ClientSocketHandler::InputResult::MORE:
+		return InputResult::MORE;
+
+	case ClientSocketHandler::InputResult::PAUSE:
+		return InputResult::PAUSE;
+
+	case ClientSocketHandler::InputResult::AGAIN:
+		return InputResult::AGAIN;
+
+	case ClientSocketHandler::InputResult::CLOSED:
+		break;
+	}
+
+	return InputResult::CLOSED;
+}
+
+void
+DirectClientSocket::OnSocketError(std::exception_ptr ep) noexcept
+{
+	handler.OnSocketError(std::move(ep));
+}
+
+void
+DirectClientSocket::OnSocketClosed() noexcept
+{
+	handler.OnSocketClosed();
+}
+
+void
+DirectClientSocket::OnSocketOutputEmpty() noexcept
+{
+	handler.OnSocketOutputEmpty();
+}
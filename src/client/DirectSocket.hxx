@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "Socket.hxx"
+#include "event/FullyBufferedSocket.hxx"
+
+/**
+ * A #ClientSocket which does all I/O in the main thread.
+ */
+class DirectClientSocket final : public ClientSocket, FullyBufferedSocket {
+	ClientSocketHandler &handler;
+
+public:
+	DirectClientSocket(SocketDescriptor _fd, EventLoop &_loop,
+			   ClientSocketHandler &_handler,
+			   std::size_t normal_size,
+			   std::size_t peak_size) noexcept
+		:FullyBufferedSocket(_fd, _loop, normal_size, peak_size),
+		 handler(_handler) {}
+
+	~DirectClientSocket() noexcept override;
+
+	/* virtual methods from class ClientSocket */
+	bool IsDefined() const noexcept override {
+		return FullyBufferedSocket::IsDefined();
+	}
+
+	void Close() noexcept override {
+		FullyBufferedSocket::Close();
+	}
+
+	void ConsumeInput(std::size_t nbytes) noexcept override {
+		FullyBufferedSocket::ConsumeInput(nbytes);
+	}
+
+	void ResumeInput() noexcept override {
+		FullyBufferedSocket::ResumeInput();
+	}
+
+	bool Write(std::span<const std::byte> src) noexcept override {
+		return FullyBufferedSocket::Write(src.data(), src.size());
+	}
+
+	bool Flush() noexcept override {
+		return FullyBufferedSocket::Flush();
+	}
+
+	std::size_t GetOutputSize() const noexcept override {
+		return FullyBufferedSocket::GetOutputSize();
+	}
+
+	std::size_t GetOutputMaxSize() const noexcept override {
+		return FullyBufferedSocket::GetOutputMaxSize();
+	}
+
+private:
+	/* virtual methods from class BufferedSocket */
+	InputResult OnSocketInput(std::span<std::byte> src) noexcept override;
+	void OnSocketError(std::exception_ptr ep) noexcept override;
+	void OnSocketClosed() noexcept override;
+
+	/* virtual methods from class FullyBufferedSocket */
+	void OnSocketOutputEmpty() noexcept override;
+};
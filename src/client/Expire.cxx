@@ -17,7 +17,7 @@ Client::SetExpired() noexcept
 		background_command.reset();
 	}
 
-	FullyBufferedSocket::Close();
+	socket->Close();
 	timeout_event.Schedule(Event::Duration::zero());
 }
 
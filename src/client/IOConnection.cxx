@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "IOConnection.hxx"
+#include "IOThreads.hxx"
+#include "ThreadedSocket.hxx"
+#include "net/SocketError.hxx"
+#include "util/SpanCast.hxx"
+
+#include <utility>
+
+ClientIOConnection::ClientIOConnection(ClientIOThread &thread,
+				       SocketDescriptor fd,
+				       ThreadedClientSocket &_socket) noexcept
+	:BufferedSocket(fd, thread.GetEventLoop()),
+	 inject_event(thread.GetEventLoop(), BIND_THIS_METHOD(OnInject)),
+	 socket(&_socket)
+{
+	thread.AddConnection(*this);
+}
+
+ClientIOConnection::~ClientIOConnection() noexcept
+{
+	if (IsDefined())
+		BufferedSocket::Close();
+}
+
+inline void
+ClientIOConnection::WakeSocket() noexcept
+{
+	if (socket != nullptr)
+		socket->inject_event.Schedule();
+}
+
+void
+ClientIOConnection::Fail(std::exception_ptr ep, bool _closed) noexcept
+{
+	BufferedSocket::Close();
+
+	const std::scoped_lock lock{mutex};
+	error = std::move(ep);
+	closed = _closed;
+	WakeSocket();
+}
+
+bool
+ClientIOConnection::SendOutput() noexcept
+{
+	bool sent = false;
+
+	while (true) {
+		if (sending_position == sending.size()) {
+			sending.clear();
+			sending_position = 0;
+
+			const std::scoped_lock lock{mutex};
+			if (submitted.empty()) {
+				event.CancelWrite();
+
+				if (sent) {
+					output_empty = true;
+					WakeSocket();
+				}
+
+				return true;
+			}
+
+			sending.swap(submitted);
+		}
+
+		const auto nbytes = GetSocket().WriteNoWait(AsBytes(std::string_view{sending}.substr(sending_position)));
+		if (nbytes < 0) [[unlikely]] {
+			const auto code = GetSocketError();
+			if (IsSocketErrorSendWouldBlock(code)) {
+				event.ScheduleWrite();
+				return true;
+			}
+
+			if (IsSocketErrorClosed(code))
+				Fail({}, true);
+			else
+				Fail(std::make_exception_ptr(MakeSocketError(code, "Failed to send to socket")),
+				     false);
+			return false;
+		}
+
+		sending_position += nbytes;
+		output_size -= nbytes;
+		sent = true;
+	}
+}
+
+void
+ClientIOConnection::OnInject() noexcept
+{
+	bool detached, resume;
+
+	{
+		const std::scoped_lock lock{mutex};
+		detached = socket == nullptr;
+		resume = std::exchange(resume_input, false);
+	}
+
+	if (IsDefined())
+		SendOutput();
+
+	if (detached) {
+		/* the ThreadedClientSocket is gone; output which
+		   could not be sent right now is discarded, just like
+		   FullyBufferedSocket::Close() does */
+		delete this;
+		return;
+	}
+
+	if (resume && IsDefined())
+		BufferedSocket::ResumeInput();
+}
+
+BufferedSocket::InputResult
+ClientIOConnection::OnSocketInput(std::span<std::byte> src) noexcept
+{
+	const std::string_view s = ToStringView(src);
+
+	/* pass only complete lines to the main thread */
+	const auto newline = s.rfind('\n');
+	if (newline == s.npos)
+		return InputResult::MORE;
+
+	const std::size_t length = newline + 1;
+
+	{
+		const std::scoped_lock lock{mutex};
+
+		if (socket == nullptr)
+			/* detached; this object is going to be
+			   destroyed */
+			return InputResult::PAUSE;
+
+		if (received.size() >= MAX_RECEIVED) {
+			/* the main thread is busy (or this client
+			   is running a command in background); wait
+			   until it has taken the pending lines */
+			input_paused = true;
+			return InputResult::PAUSE;
+		}
+
+		received.append(s.substr(0, length));
+		WakeSocket();
+	}
+
+	ConsumeInput(length);
+	return InputResult::MORE;
+}
+
+void
+ClientIOConnection::OnSocketError(std::exception_ptr ep) noexcept
+{
+	Fail(std::move(ep), false);
+}
+
+void
+ClientIOConnection::OnSocketClosed() noexcept
+{
+	Fail({}, true);
+}
+
+void
+ClientIOConnection::OnSocketReady(unsigned flags) noexcept
+{
+	if ((flags & SocketEvent::WRITE) && !SendOutput())
+		return;
+
+	BufferedSocket::OnSocketReady(flags);
+}
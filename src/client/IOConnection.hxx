@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "event/BufferedSocket.hxx"
+#include "event/InjectEvent.hxx"
+#include "thread/Mutex.hxx"
+#include "util/IntrusiveList.hxx"
+
+#include <atomic>
+#include <exception>
+#include <string>
+
+class ClientIOThread;
+class ThreadedClientSocket;
+
+/**
+ * The part of a #ThreadedClientSocket which lives in a
+ * #ClientIOThread: it owns the socket, splits the input into lines
+ * and sends the output.
+ *
+ * The #ThreadedClientSocket communicates with this object through
+ * the attributes protected by #mutex; both sides wake each other up
+ * with an #InjectEvent.  This object destroys itself (inside the
+ * I/O thread) after the #ThreadedClientSocket has detached.
+ */
+class ClientIOConnection final
+	: BufferedSocket, public AutoUnlinkIntrusiveListHook
+{
+	friend class ThreadedClientSocket;
+
+	/**
+	 * Stop reading from the socket while this many bytes of
+	 * input have not yet been taken by the main thread.
+	 */
+	static constexpr std::size_t MAX_RECEIVED = 16384;
+
+	/**
+	 * Wakes up the I/O thread; scheduled by the
+	 * #ThreadedClientSocket.
+	 */
+	InjectEvent inject_event;
+
+	mutable Mutex mutex;
+
+	/**
+	 * The #ThreadedClientSocket which owns this object or
+	 * nullptr if it has detached.  Protected by #mutex.
+	 */
+	ThreadedClientSocket *socket;
+
+	/**
+	 * Complete lines received from the socket which shall be
+	 * handled by the main thread.  Protected by #mutex.
+	 */
+	std::string received;
+
+	/**
+	 * Output submitted by the main thread which has not yet been
+	 * moved to #sending.  Protected by #mutex.
+	 */
+	std::string submitted;
+
+	/**
+	 * The error which occurred on the socket, to be reported to
+	 * the main thread.  Protected by #mutex.
+	 */
+	std::exception_ptr error;
+
+	/**
+	 * The peer has closed the connection.  Protected by #mutex.
+	 */
+	bool closed = false;
+
+	/**
+	 * Has reading been paused because #received is full?
+	 * Protected by #mutex.
+	 */
+	bool input_paused = false;
+
+	/**
+	 * The main thread has taken data from #received after
+	 * #input_paused had been set.  Protected by #mutex.
+	 */
+	bool resume_input = false;
+
+	/**
+	 * The output has been sent completely; notify the main
+	 * thread.  Protected by #mutex.
+	 */
+	bool output_empty = false;
+
+	/**
+	 * The number of bytes submitted by the main thread which
+	 * have not yet been sent to the socket.
+	 */
+	std::atomic_size_t output_size{0};
+
+	/**
+	 * The output which is currently being sent; only accessed in
+	 * the I/O thread.
+	 */
+	std::string sending;
+
+	/**
+	 * The number of bytes of #sending which have already been
+	 * sent.
+	 */
+	std::size_t sending_position = 0;
+
+public:
+	/**
+	 * Must be called inside the I/O thread.
+	 */
+	ClientIOConnection(ClientIOThread &thread, SocketDescriptor fd,
+			   ThreadedClientSocket &_socket) noexcept;
+
+	~ClientIOConnection() noexcept;
+
+private:
+	/**
+	 * Send as much of the output as possible.
+	 *
+	 * @return false if an error has occurred (it has already
+	 * been reported to the main thread)
+	 */
+	bool SendOutput() noexcept;
+
+	/**
+	 * Record an error for the main thread and close the socket.
+	 */
+	void Fail(std::exception_ptr ep, bool _closed) noexcept;
+
+	/**
+	 * Wake up the #ThreadedClientSocket.  Caller must hold
+	 * #mutex.
+	 */
+	void WakeSocket() noexcept;
+
+	void OnInject() noexcept;
+
+	/* virtual methods from class BufferedSocket */
+	InputResult OnSocketInput(std::span<std::byte> src) noexcept override;
+	void OnSocketError(std::exception_ptr ep) noexcept override;
+	void OnSocketClosed() noexcept override;
+	void OnSocketReady(unsigned flags) noexcept override;
+};
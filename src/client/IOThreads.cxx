@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "IOThreads.hxx"
+#include "IOConnection.hxx"
+#include "util/DeleteDisposer.hxx"
+
+ClientIOThread::ClientIOThread() noexcept = default;
+
+ClientIOThread::~ClientIOThread() noexcept
+{
+	Stop();
+}
+
+void
+ClientIOThread::Stop() noexcept
+{
+	thread.Stop();
+
+	/* the thread has exited, so it is safe to destroy the
+	   connections which were detached but have not yet
+	   destroyed themselves */
+	connections.clear_and_dispose(DeleteDisposer{});
+}
+
+void
+ClientIOThread::AddConnection(ClientIOConnection &connection) noexcept
+{
+	connections.push_back(connection);
+}
+
+ClientIOThreads::ClientIOThreads(unsigned _n_threads)
+	:threads(new ClientIOThread[_n_threads]),
+	 n_threads(_n_threads)
+{
+}
+
+ClientIOThreads::~ClientIOThreads() noexcept = default;
+
+void
+ClientIOThreads::Start()
+{
+	for (unsigned i = 0; i < n_threads; ++i)
+		threads[i].Start();
+}
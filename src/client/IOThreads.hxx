@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "event/Thread.hxx"
+#include "util/IntrusiveList.hxx"
+
+#include <memory>
+
+class ClientIOConnection;
+
+/**
+ * A thread which does the socket I/O of some clients (see
+ * #ThreadedClientSocket).
+ */
+class ClientIOThread {
+	EventThread thread;
+
+	/**
+	 * All #ClientIOConnection instances running in this thread.
+	 * This list is only accessed from inside the thread (or after
+	 * it has been stopped).
+	 */
+	IntrusiveList<ClientIOConnection> connections;
+
+public:
+	ClientIOThread() noexcept;
+	~ClientIOThread() noexcept;
+
+	ClientIOThread(const ClientIOThread &) = delete;
+	ClientIOThread &operator=(const ClientIOThread &) = delete;
+
+	EventLoop &GetEventLoop() noexcept {
+		return thread.GetEventLoop();
+	}
+
+	void Start() {
+		thread.Start();
+	}
+
+	/**
+	 * Stop the thread and destroy all remaining connections.
+	 */
+	void Stop() noexcept;
+
+	/**
+	 * Called by #ClientIOConnection from inside the thread.
+	 */
+	void AddConnection(ClientIOConnection &connection) noexcept;
+};
+
+/**
+ * A fixed number of #ClientIOThread instances; new clients are
+ * assigned to them in round-robin order.
+ */
+class ClientIOThreads {
+	const std::unique_ptr<ClientIOThread[]> threads;
+	const unsigned n_threads;
+
+	unsigned next = 0;
+
+public:
+	explicit ClientIOThreads(unsigned _n_threads);
+	~ClientIOThreads() noexcept;
+
+	void Start();
+
+	/**
+	 * Choose a thread for a new client.
+	 */
+	ClientIOThread &Next() noexcept {
+		auto &thread = threads[next];
+		next = (next + 1) % n_threads;
+		return thread;
+	}
+};
@@ -3,23 +3,54 @@
 
 #include "Client.hxx"
 #include "Config.hxx"
+#include "Domain.hxx"
 #include "Response.hxx"
+#include "Partition.hxx"
+#include "PlaylistPrint.hxx"
+#include "command/PlayerCommands.hxx"
+#include "output/Print.hxx"
 #include "protocol/IdleFlags.hxx"
+#include "protocol/RangeArg.hxx"
+#include "lib/fmt/ExceptionFormatter.hxx"
+#include "Log.hxx"
 
 #include <fmt/format.h>
 
 #include <cassert>
 
 static void
-WriteIdleResponse(Response &r, unsigned flags) noexcept
+WriteIdleFlags(Response &r, unsigned flags) noexcept
 {
 	const char *const*idle_names = idle_get_names();
 	for (unsigned i = 0; idle_names[i]; ++i) {
 		if (flags & (1 << i))
 			r.Fmt("changed: {}\n", idle_names[i]);
 	}
+}
 
-	r.Write("OK\n");
+/**
+ * Write the data which has changed, so the client doesn't need to
+ * query it (protocol feature "idle_payload").
+ *
+ * @param playlist_version the queue version which was last
+ * reported to this client; will be updated
+ */
+static void
+WriteIdlePayload(Response &r, Partition &partition, unsigned flags,
+		 uint32_t &playlist_version)
+{
+	if (flags & (IDLE_PLAYER|IDLE_MIXER|IDLE_OPTIONS|IDLE_PLAYLIST|IDLE_UPDATE))
+		PrintStatus(r, partition);
+
+	if (flags & IDLE_PLAYLIST) {
+		playlist_print_changes_position(r, partition.playlist,
+						playlist_version,
+						RangeArg::All());
+		playlist_version = partition.playlist.GetVersion();
+	}
+
+	if (flags & IDLE_OUTPUT)
+		printAudioDevices(r, partition.outputs);
 }
 
 void
@@ -34,7 +65,19 @@ Client::IdleNotify() noexcept
 	idle_waiting = false;
 
 	Response r(*this, 0);
-	WriteIdleResponse(r, flags);
+	WriteIdleFlags(r, flags);
+
+	if (ProtocolFeatureEnabled(PF_IDLE_PAYLOAD)) {
+		try {
+			WriteIdlePayload(r, *partition, flags,
+					 idle_playlist_version);
+		} catch (...) {
+			FmtError(client_domain, "[{}] failed to generate idle payload: {}",
+				 name, std::current_exception());
+		}
+	}
+
+	r.Write("OK\n");
 
 	timeout_event.Schedule(client_timeout);
 }
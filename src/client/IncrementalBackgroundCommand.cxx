@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "IncrementalBackgroundCommand.hxx"
+#include "Client.hxx"
+#include "Response.hxx"
+#include "command/CommandError.hxx"
+
+#include <algorithm> // for std::min()
+#include <cassert>
+
+IncrementalBackgroundCommand::IncrementalBackgroundCommand(Client &_client,
+							   const char *_command) noexcept
+	:client(_client), command(_command),
+	 defer_resume(_client.GetEventLoop(), BIND_THIS_METHOD(OnResume))
+{
+}
+
+CommandResult
+IncrementalBackgroundCommand::Start(std::unique_ptr<IncrementalBackgroundCommand> cmd,
+				    Response &r)
+{
+	Client &client = cmd->client;
+
+	if (client.IsInCommandList()) {
+		/* going to background would discard the rest of the
+		   command list */
+		while (!cmd->Generate(r)) {}
+		return CommandResult::OK;
+	}
+
+	if (cmd->GenerateSlice(r))
+		return CommandResult::OK;
+
+	cmd->ScheduleResume();
+	client.SetBackgroundCommand(std::move(cmd));
+	return CommandResult::BACKGROUND;
+}
+
+bool
+IncrementalBackgroundCommand::IsOutputFull() const noexcept
+{
+	const std::size_t threshold =
+		std::min(OUTPUT_THRESHOLD, client.GetOutputMaxSize() / 2);
+	return client.GetOutputSize() >= threshold;
+}
+
+bool
+IncrementalBackgroundCommand::ShouldSuspend() const noexcept
+{
+	if (client.IsInCommandList())
+		return false;
+
+	return IsOutputFull() ||
+		std::chrono::steady_clock::now() >= deadline;
+}
+
+inline bool
+IncrementalBackgroundCommand::GenerateSlice(Response &r)
+{
+	deadline = std::chrono::steady_clock::now() + TIME_SLICE;
+	return Generate(r);
+}
+
+inline void
+IncrementalBackgroundCommand::ScheduleResume() noexcept
+{
+	if (!IsOutputFull())
+		/* the time slice is over; continue after other
+		   events have been handled */
+		defer_resume.ScheduleNext();
+
+	/* else: OnClientOutputEmpty() will resume generation */
+}
+
+void
+IncrementalBackgroundCommand::Cancel() noexcept
+{
+	defer_resume.Cancel();
+}
+
+void
+IncrementalBackgroundCommand::OnClientOutputEmpty() noexcept
+{
+	/* don't starve other clients: resume only after pending I/O
+	   events have been handled */
+	defer_resume.ScheduleNext();
+}
+
+void
+IncrementalBackgroundCommand::OnResume() noexcept
+{
+	/* writing to the client may fail and make it expire, which
+	   would delete its BackgroundCommand (i.e. this object)
+	   while Generate() is running; to avoid this, take ownership
+	   during Generate() */
+	auto self = client.ReleaseBackgroundCommand();
+	assert(self.get() == this);
+
+	Response r(client, 0);
+	r.SetCommand(command);
+
+	bool finished = true;
+
+	try {
+		finished = GenerateSlice(r);
+		if (finished)
+			client.WriteOK();
+	} catch (...) {
+		PrintError(r, std::current_exception());
+	}
+
+	if (client.IsExpired())
+		/* the client is going to be closed; this object
+		   will be deleted by "self" */
+		return;
+
+	/* OnBackgroundCommandFinished() expects the BackgroundCommand
+	   to be installed, and it will delete this object */
+	client.SetBackgroundCommand(std::move(self));
+
+	if (finished)
+		client.OnBackgroundCommandFinished();
+	else
+		ScheduleResume();
+}
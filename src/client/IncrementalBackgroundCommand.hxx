@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "BackgroundCommand.hxx"
+#include "command/CommandResult.hxx"
+#include "event/DeferEvent.hxx"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+class Client;
+class Response;
+
+/**
+ * A #BackgroundCommand which generates a (possibly huge) response
+ * incrementally inside the client's #EventLoop thread.  Generation
+ * is suspended whenever the client's output buffer has grown beyond
+ * a threshold, and it is resumed after the output buffer has been
+ * sent to the socket.  This way, the memory used per client stays
+ * bounded, no matter how large the response is.  Additionally, each
+ * step is limited to a short time slice, so other clients are not
+ * blocked by a slow command.
+ *
+ * Responses which fit into the threshold are generated completely
+ * by Start(), without the overhead of going to background.
+ */
+class IncrementalBackgroundCommand : public BackgroundCommand {
+	/**
+	 * Suspend generation as soon as the client's output buffer
+	 * contains this number of bytes.
+	 */
+	static constexpr std::size_t OUTPUT_THRESHOLD = 64 * 1024;
+
+	/**
+	 * The maximum duration of one Generate() call.
+	 */
+	static constexpr std::chrono::steady_clock::duration TIME_SLICE =
+		std::chrono::milliseconds(5);
+
+	Client &client;
+
+	/**
+	 * The command name, used for error messages.
+	 */
+	const char *const command;
+
+	DeferEvent defer_resume;
+
+	/**
+	 * The end of the current time slice.  See ShouldSuspend().
+	 */
+	std::chrono::steady_clock::time_point deadline;
+
+public:
+	IncrementalBackgroundCommand(Client &_client,
+				     const char *_command) noexcept;
+
+	/**
+	 * Generate the first part of the response.  If the whole
+	 * response has been generated, the object is deleted and
+	 * #CommandResult::OK is returned.  Otherwise, it is installed
+	 * as the client's #BackgroundCommand and
+	 * #CommandResult::BACKGROUND is returned.
+	 *
+	 * Inside a command list, the whole response is generated
+	 * synchronously.
+	 *
+	 * Throws on error (from Generate()).
+	 */
+	static CommandResult Start(std::unique_ptr<IncrementalBackgroundCommand> cmd,
+				   Response &r);
+
+	void Cancel() noexcept final;
+	void OnClientOutputEmpty() noexcept final;
+
+protected:
+	Client &GetClient() const noexcept {
+		return client;
+	}
+
+	/**
+	 * Should Generate() return now?  This is the case if the
+	 * client's output buffer is full or if the time slice is
+	 * over.
+	 */
+	[[gnu::pure]]
+	bool ShouldSuspend() const noexcept;
+
+	/**
+	 * Generate the next part of the response.  The
+	 * implementation should write to the given #Response until
+	 * ShouldSuspend() returns true.  If it throws, the exception
+	 * is converted to an error response and the command is
+	 * finished.
+	 *
+	 * @return true if the response is complete, false if this
+	 * method shall be called again later
+	 */
+	virtual bool Generate(Response &r) = 0;
+
+private:
+	[[gnu::pure]]
+	bool IsOutputFull() const noexcept;
+
+	/**
+	 * Invoke Generate() with a new time slice.
+	 */
+	bool GenerateSlice(Response &r);
+
+	/**
+	 * Generate() has returned false: schedule the next call.
+	 */
+	void ScheduleResume() noexcept;
+
+	void OnResume() noexcept;
+};
@@ -6,8 +6,12 @@
 #include "Domain.hxx"
 #include "List.hxx"
 #include "BackgroundCommand.hxx"
+#include "DirectSocket.hxx"
+#include "ThreadedSocket.hxx"
+#include "IOThreads.hxx"
 #include "Partition.hxx"
 #include "Instance.hxx"
+#include "lib/fmt/ExceptionFormatter.hxx"
 #include "lib/fmt/SocketAddressFormatter.hxx"
 #include "net/PeerCredentials.hxx"
 #include "net/UniqueSocketDescriptor.hxx"
@@ -17,6 +21,10 @@
 #include "Log.hxx"
 #include "Version.h"
 
+#ifdef ENABLE_ZLIB
+#include "Compressor.hxx"
+#endif
+
 #include <fmt/core.h>
 
 #include <cassert>
@@ -25,18 +33,37 @@ using std::string_view_literals::operator""sv;
 
 static constexpr auto GREETING = "OK MPD " PROTOCOL_VERSION "\n"sv;
 
+static std::unique_ptr<ClientSocket>
+MakeClientSocket(EventLoop &loop, UniqueSocketDescriptor &&fd,
+		 ClientSocketHandler &handler, ClientIOThread *io_thread)
+{
+	if (io_thread != nullptr)
+		return std::make_unique<ThreadedClientSocket>(loop, *io_thread,
+							      std::move(fd),
+							      handler,
+							      client_max_output_buffer_size);
+
+	return std::make_unique<DirectClientSocket>(fd.Release(), loop,
+						    handler,
+						    16384,
+						    client_max_output_buffer_size);
+}
+
 Client::Client(EventLoop &_loop, Partition &_partition,
-	       UniqueSocketDescriptor _fd,
+	       UniqueSocketDescriptor &&_fd,
 	       int _uid, unsigned _permission,
-	       std::string &&_name) noexcept
-	:FullyBufferedSocket(_fd.Release(), _loop,
-			     16384, client_max_output_buffer_size),
-	 name(std::move(_name)),
+	       std::string &&_name,
+	       ClientIOThread *io_thread)
+	:name(std::move(_name)),
+	 socket(MakeClientSocket(_loop, std::move(_fd), *this, io_thread)),
 	 timeout_event(_loop, BIND_THIS_METHOD(OnTimeout)),
 	 partition(&_partition),
 	 permission(_permission),
 	 uid(_uid),
 	 last_album_art(_loop)
+#ifdef ENABLE_ZLIB
+	, compressor_flush_event(_loop, BIND_THIS_METHOD(FlushCompressor))
+#endif
 {
 	FmtInfo(client_domain, "[{}] client connected", name);
 
@@ -75,9 +102,23 @@ client_new(EventLoop &loop, Partition &partition,
 
 	const int uid = cred.IsDefined() ? static_cast<int>(cred.GetUid()) : -1;
 
-	auto *client = new Client(loop, partition, std::move(fd), uid,
-				  permission,
-				  MakeClientName(remote_address, cred));
+	auto &instance = partition.instance;
+	ClientIOThread *io_thread = instance.client_io_threads
+		? &instance.client_io_threads->Next()
+		: nullptr;
+
+	Client *client;
+
+	try {
+		client = new Client(loop, partition, std::move(fd), uid,
+				    permission,
+				    MakeClientName(remote_address, cred),
+				    io_thread);
+	} catch (...) {
+		FmtError(client_domain, "Failed to set up client: {}",
+			 std::current_exception());
+		return;
+	}
 
 	client_list.Add(*client);
 	partition.clients.push_back(*client);
@@ -89,8 +130,8 @@ Client::Close() noexcept
 	partition->instance.client_list->Remove(*this);
 	partition->clients.erase(partition->clients.iterator_to(*this));
 
-	if (FullyBufferedSocket::IsDefined())
-		FullyBufferedSocket::Close();
+	if (socket->IsDefined())
+		socket->Close();
 
 	FmtInfo(client_domain, "[{}] disconnected", name);
 	delete this;
@@ -4,38 +4,184 @@
 #include "Client.hxx"
 #include "Config.hxx"
 #include "Domain.hxx"
+#include "BackgroundCommand.hxx"
+#include "Partition.hxx"
+#include "Instance.hxx"
 #include "command/AllCommands.hxx"
+#include "event/DeferEvent.hxx"
 #include "Log.hxx"
 #include "util/StringAPI.hxx"
 #include "util/CharUtil.hxx"
+#include "util/ScopeExit.hxx"
+
+#include <cassert>
+#include <chrono>
 
 #define CLIENT_LIST_MODE_BEGIN "command_list_begin"
 #define CLIENT_LIST_OK_MODE_BEGIN "command_list_ok_begin"
 #define CLIENT_LIST_MODE_END "command_list_end"
 
-inline CommandResult
-Client::ProcessCommandList(bool list_ok,
-			   std::list<std::string> &&list) noexcept
+/**
+ * A command list is suspended after it has been running for this
+ * duration, to give other clients a chance.
+ */
+static constexpr std::chrono::steady_clock::duration COMMAND_LIST_TIME_SLICE =
+	std::chrono::milliseconds(10);
+
+/**
+ * The remainder of a command list which has exceeded its time slice.
+ * It is installed as the client's #BackgroundCommand (which
+ * suspends input processing) and continues the command list after
+ * the #EventLoop has handled other events.
+ */
+class CommandListContinuation final : public BackgroundCommand {
+	Client &client;
+
+	DeferEvent defer_resume;
+
+public:
+	std::list<std::string> list;
+
+	/**
+	 * The index of the first command in #list within the
+	 * original command list.
+	 */
+	unsigned n;
+
+	const bool list_ok;
+
+	CommandListContinuation(Client &_client,
+				std::list<std::string> &&_list,
+				unsigned _n, bool _list_ok) noexcept
+		:client(_client),
+		 defer_resume(client.GetEventLoop(), BIND_THIS_METHOD(OnResume)),
+		 list(std::move(_list)), n(_n), list_ok(_list_ok) {}
+
+	void ScheduleResume() noexcept {
+		defer_resume.ScheduleNext();
+	}
+
+	/* virtual methods from class BackgroundCommand */
+	void Cancel() noexcept override {
+		defer_resume.Cancel();
+	}
+
+private:
+	void OnResume() noexcept {
+		client.ResumeCommandList(*this);
+	}
+};
+
+CommandResult
+Client::ExecuteCommandList(std::list<std::string> &list, unsigned &n,
+			   bool list_ok, bool &suspended) noexcept
 {
-	unsigned n = 0;
+	const auto deadline = std::chrono::steady_clock::now() +
+		COMMAND_LIST_TIME_SLICE;
+	suspended = false;
+
+	in_command_list = true;
+	AtScopeExit(this) { in_command_list = false; };
 
-	for (auto &&i : list) {
-		char *cmd = &*i.begin();
+	while (!list.empty()) {
+		char *cmd = &*list.front().begin();
 
 		FmtDebug(client_domain, "process command {:?}", cmd);
 		auto ret = command_process(*this, n++, cmd);
 		FmtDebug(client_domain, "command returned {}", unsigned(ret));
+		list.pop_front();
+
 		if (IsExpired())
 			return CommandResult::CLOSE;
 		else if (ret != CommandResult::OK)
 			return ret;
 		else if (list_ok)
 			Write("list_OK\n");
+
+		if (!list.empty() &&
+		    std::chrono::steady_clock::now() >= deadline) {
+			suspended = true;
+			break;
+		}
 	}
 
 	return CommandResult::OK;
 }
 
+inline CommandResult
+Client::ProcessCommandList(bool list_ok,
+			   std::list<std::string> &&list) noexcept
+{
+	unsigned n = 0;
+	bool suspended;
+
+	auto ret = ExecuteCommandList(list, n, list_ok, suspended);
+	if (!suspended)
+		return ret;
+
+	auto c = std::make_unique<CommandListContinuation>(*this,
+							   std::move(list),
+							   n, list_ok);
+	c->ScheduleResume();
+	SetBackgroundCommand(std::move(c));
+	return CommandResult::BACKGROUND;
+}
+
+void
+Client::ResumeCommandList(CommandListContinuation &c) noexcept
+{
+	/* protect the object from being deleted by SetExpired()
+	   while commands are running */
+	auto self = ReleaseBackgroundCommand();
+	assert(self.get() == &c);
+
+	bool suspended;
+	auto ret = ExecuteCommandList(c.list, c.n, c.list_ok, suspended);
+
+	if (suspended) {
+		c.ScheduleResume();
+		SetBackgroundCommand(std::move(self));
+		return;
+	}
+
+	switch (ret) {
+	case CommandResult::OK:
+		WriteOK();
+		[[fallthrough]];
+
+	case CommandResult::ERROR:
+	case CommandResult::IDLE:
+		FinishResponse();
+
+		/* OnBackgroundCommandFinished() expects the
+		   BackgroundCommand to be installed, and it will
+		   delete it */
+		SetBackgroundCommand(std::move(self));
+		OnBackgroundCommandFinished();
+		break;
+
+	case CommandResult::BACKGROUND:
+		/* a command has installed its own
+		   BackgroundCommand; "self" is not needed anymore */
+		break;
+
+	case CommandResult::KILL:
+		partition->instance.Break();
+		Close();
+		break;
+
+	case CommandResult::FINISH:
+		FinishResponse();
+		if (socket->Flush())
+			Close();
+		break;
+
+	case CommandResult::CLOSE:
+		Close();
+		break;
+	}
+}
+
 [[gnu::pure]]
 static bool
 IsAsyncCommmand(const char *line) noexcept
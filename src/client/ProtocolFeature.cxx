@@ -18,6 +18,11 @@ struct feature_type_table {
 
 static constexpr struct feature_type_table protocol_feature_names_init[] = {
 	{"hide_playlists_in_root", PF_HIDE_PLAYLISTS_IN_ROOT},
+	{"binary_songs", PF_BINARY_SONGS},
+	{"idle_payload", PF_IDLE_PAYLOAD},
+#ifdef ENABLE_ZLIB
+	{"gzip", PF_GZIP},
+#endif
 };
 
 /**
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "config.h" // for ENABLE_ZLIB
+
 #include <string_view>
 #include <cstdint>
 
@@ -14,6 +16,11 @@ class Response;
  */
 enum ProtocolFeatureType : uint8_t {
 	PF_HIDE_PLAYLISTS_IN_ROOT,
+	PF_BINARY_SONGS,
+	PF_IDLE_PAYLOAD,
+#ifdef ENABLE_ZLIB
+	PF_GZIP,
+#endif
 
 	PF_NUM_OF_ITEM_TYPES
 };
@@ -9,7 +9,7 @@
 
 #include <cstring>
 
-BufferedSocket::InputResult
+ClientSocketHandler::InputResult
 Client::OnSocketInput(std::span<std::byte> src) noexcept
 {
 	if (background_command)
@@ -22,7 +22,7 @@ Client::OnSocketInput(std::span<std::byte> src) noexcept
 
 	timeout_event.Schedule(client_timeout);
 
-	BufferedSocket::ConsumeInput(newline + 1 - p);
+	socket->ConsumeInput(newline + 1 - p);
 
 	/* skip whitespace at the end of the line */
 	char *end = StripRight(p, newline);
@@ -31,6 +31,9 @@ Client::OnSocketInput(std::span<std::byte> src) noexcept
 	*end = 0;
 
 	CommandResult result = ProcessLine(p);
+	if (!IsExpired())
+		FinishResponse();
+
 	switch (result) {
 	case CommandResult::OK:
 	case CommandResult::IDLE:
@@ -44,7 +47,7 @@ Client::OnSocketInput(std::span<std::byte> src) noexcept
 		return InputResult::CLOSED;
 
 	case CommandResult::FINISH:
-		if (Flush())
+		if (socket->Flush())
 			Close();
 		return InputResult::CLOSED;
 
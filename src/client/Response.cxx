@@ -6,22 +6,58 @@
 
 #include <fmt/format.h>
 
+#include <string.h>
+
 TagMask
 Response::GetTagMask() const noexcept
 {
 	return GetClient().tag_mask;
 }
 
+bool
+Response::ProtocolFeatureEnabled(ProtocolFeatureType feature) const noexcept
+{
+	return GetClient().ProtocolFeatureEnabled(feature);
+}
+
 bool
 Response::Write(const void *data, size_t length) noexcept
 {
-	return client.Write(data, length);
+	if (buffer != nullptr) {
+		if (buffer_overflow ||
+		    buffer->size() + length > client.GetOutputMaxSize()) {
+			buffer_overflow = true;
+			return false;
+		}
+
+		buffer->append(static_cast<const char *>(data), length);
+		bytes_written += length;
+		return true;
+	}
+
+	if (capture != nullptr) {
+		if (capture->size() + length <= capture_limit) {
+			capture->append(static_cast<const char *>(data), length);
+		} else {
+			capture = nullptr;
+			capture_failed = true;
+		}
+	}
+
+	if (!client.Write(data, length)) {
+		capture = nullptr;
+		capture_failed = true;
+		return false;
+	}
+
+	bytes_written += length;
+	return true;
 }
 
 bool
 Response::Write(const char *data) noexcept
 {
-	return client.Write(data);
+	return Write(data, strlen(data));
 }
 
 bool
@@ -3,12 +3,14 @@
 
 #pragma once
 
+#include "ProtocolFeature.hxx"
 #include "protocol/Ack.hxx"
 
 #include <fmt/core.h>
 
 #include <cstddef>
 #include <span>
+#include <string>
 
 class Client;
 class TagMask;
@@ -27,10 +29,55 @@ class Response {
 	 */
 	const char *command = "";
 
+	/**
+	 * If not nullptr, then all output is appended to this buffer
+	 * instead of being sent to the client.  This allows
+	 * generating a response in another thread.
+	 */
+	std::string *const buffer = nullptr;
+
+	/**
+	 * Set if #buffer would have grown beyond the client's
+	 * maximum output buffer size.
+	 */
+	bool buffer_overflow = false;
+
+	/**
+	 * If not nullptr, then all data written to the client is
+	 * copied to this buffer.  See StartCapture().
+	 */
+	std::string *capture = nullptr;
+
+	/**
+	 * The maximum size of #capture.
+	 */
+	std::size_t capture_limit;
+
+	/**
+	 * Set if the capture was aborted, because the limit was
+	 * exceeded or because writing to the client failed.
+	 */
+	bool capture_failed;
+
+	/**
+	 * The number of bytes written so far.
+	 */
+	std::size_t bytes_written = 0;
+
 public:
 	Response(Client &_client, unsigned _list_index) noexcept
 		:client(_client), list_index(_list_index) {}
 
+	/**
+	 * Construct a #Response which appends everything to the given
+	 * buffer instead of sending it to the client.  Unlike the
+	 * other constructor, this one may be used in any thread, as
+	 * long as the #Client's settings are not modified meanwhile.
+	 */
+	Response(Client &_client, unsigned _list_index,
+		 std::string &_buffer) noexcept
+		:client(_client), list_index(_list_index), buffer(&_buffer) {}
+
 	Response(const Response &) = delete;
 	Response &operator=(const Response &) = delete;
 
@@ -51,10 +98,56 @@ public:
 	[[gnu::pure]]
 	TagMask GetTagMask() const noexcept;
 
+	/**
+	 * Wrapper for Client::ProtocolFeatureEnabled().  Can be used
+	 * if caller wants to avoid including Client.hxx.
+	 */
+	[[gnu::pure]]
+	bool ProtocolFeatureEnabled(ProtocolFeatureType feature) const noexcept;
+
+	const char *GetCommand() const noexcept {
+		return command;
+	}
+
 	void SetCommand(const char *_command) noexcept {
 		command = _command;
 	}
 
+	std::size_t GetBytesWritten() const noexcept {
+		return bytes_written;
+	}
+
+	/**
+	 * Was output discarded because the buffer passed to the
+	 * constructor would have become too large?
+	 */
+	bool IsBufferOverflow() const noexcept {
+		return buffer_overflow;
+	}
+
+	/**
+	 * Start copying everything written to the client into the
+	 * given buffer.  Capturing is aborted if the buffer would
+	 * grow beyond the given size.
+	 */
+	void StartCapture(std::string &buffer, std::size_t limit) noexcept {
+		capture = &buffer;
+		capture_limit = limit;
+		capture_failed = false;
+	}
+
+	/**
+	 * Stop capturing.
+	 *
+	 * @return true if the buffer contains the complete response
+	 * which was written (successfully) since StartCapture()
+	 */
+	bool StopCapture() noexcept {
+		const bool success = capture != nullptr;
+		capture = nullptr;
+		return success && !capture_failed;
+	}
+
 	bool Write(const void *data, size_t length) noexcept;
 	bool Write(const char *data) noexcept;
 
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <span>
+
+/**
+ * Receives events from a #ClientSocket.  All methods are called in
+ * the main thread.
+ */
+class ClientSocketHandler {
+public:
+	enum class InputResult {
+		/**
+		 * The method was successful, and it is ready to
+		 * receive more data.
+		 */
+		MORE,
+
+		/**
+		 * The method does not want to get more data for now.
+		 * It will call ClientSocket::ResumeInput() when it's
+		 * ready for more.
+		 */
+		PAUSE,
+
+		/**
+		 * The method wants to be called again immediately, if
+		 * there's more data in the buffer.
+		 */
+		AGAIN,
+
+		/**
+		 * The method has closed (and destroyed) the socket.
+		 */
+		CLOSED,
+	};
+
+	/**
+	 * Data has been received.
+	 *
+	 * @param src the buffer containing the data; the buffer may
+	 * be modified by the method while it processes the data
+	 */
+	virtual InputResult OnSocketInput(std::span<std::byte> src) noexcept = 0;
+
+	virtual void OnSocketError(std::exception_ptr ep) noexcept = 0;
+	virtual void OnSocketClosed() noexcept = 0;
+
+	/**
+	 * Called after the output buffer has been sent completely to
+	 * the socket.  The implementation must not close or destroy
+	 * the socket.
+	 */
+	virtual void OnSocketOutputEmpty() noexcept = 0;
+};
+
+/**
+ * The connection of a #Client.  Its methods may only be called in
+ * the main thread, but the implementation may do the actual socket
+ * I/O in another thread.
+ */
+class ClientSocket {
+public:
+	virtual ~ClientSocket() noexcept = default;
+
+	virtual bool IsDefined() const noexcept = 0;
+
+	/**
+	 * Close the socket.  Data which has not been sent yet may be
+	 * discarded.
+	 */
+	virtual void Close() noexcept = 0;
+
+	/**
+	 * Mark a portion of the input buffer "consumed".  Only
+	 * allowed to be called from
+	 * ClientSocketHandler::OnSocketInput().
+	 */
+	virtual void ConsumeInput(std::size_t nbytes) noexcept = 0;
+
+	/**
+	 * Continue delivering input after
+	 * ClientSocketHandler::OnSocketInput() has returned
+	 * InputResult::PAUSE.
+	 */
+	virtual void ResumeInput() noexcept = 0;
+
+	/**
+	 * @return false if the socket has been closed
+	 */
+	virtual bool Write(std::span<const std::byte> src) noexcept = 0;
+
+	/**
+	 * Attempt to send the output buffer right now.
+	 *
+	 * @return false if the socket has been closed
+	 */
+	virtual bool Flush() noexcept = 0;
+
+	/**
+	 * @return the number of bytes which have not yet been sent
+	 * to the socket
+	 */
+	[[gnu::pure]]
+	virtual std::size_t GetOutputSize() const noexcept = 0;
+
+	virtual std::size_t GetOutputMaxSize() const noexcept = 0;
+};
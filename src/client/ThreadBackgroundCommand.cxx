@@ -2,6 +2,7 @@
 // Copyright The Music Player Daemon Project
 
 #include "ThreadBackgroundCommand.hxx"
+#include "ThreadBackgroundQueue.hxx"
 #include "Client.hxx"
 #include "Response.hxx"
 #include "command/CommandError.hxx"
@@ -13,6 +14,26 @@ ThreadBackgroundCommand::ThreadBackgroundCommand(Client &_client) noexcept
 {
 }
 
+void
+ThreadBackgroundCommand::Start(ThreadBackgroundQueue &_queue)
+{
+	assert(queue == nullptr);
+
+	_queue.Submit(*this);
+	queue = &_queue;
+}
+
+void
+ThreadBackgroundCommand::StartQueued() noexcept
+{
+	try {
+		thread.Start();
+	} catch (...) {
+		error = std::current_exception();
+		defer_finish.Schedule();
+	}
+}
+
 void
 ThreadBackgroundCommand::_Run() noexcept
 {
@@ -31,7 +52,12 @@ void
 ThreadBackgroundCommand::DeferredFinish() noexcept
 {
 	/* free the Thread */
-	thread.Join();
+	if (thread.IsDefined())
+		thread.Join();
+
+	if (queue != nullptr)
+		/* let the next waiting command run */
+		queue->Remove(*this);
 
 	/* send the response */
 	Response response(client, 0);
@@ -50,8 +76,13 @@ ThreadBackgroundCommand::DeferredFinish() noexcept
 void
 ThreadBackgroundCommand::Cancel() noexcept
 {
-	CancelThread();
-	thread.Join();
+	if (thread.IsDefined()) {
+		CancelThread();
+		thread.Join();
+	}
+
+	if (queue != nullptr)
+		queue->Remove(*this);
 
 	/* cancel the InjectEvent, just in case the Thread has
 	   meanwhile finished execution */
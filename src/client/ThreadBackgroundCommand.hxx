@@ -7,20 +7,32 @@
 #include "BackgroundCommand.hxx"
 #include "event/InjectEvent.hxx"
 #include "thread/Thread.hxx"
+#include "util/IntrusiveList.hxx"
 
 #include <exception>
 
 class Client;
 class Response;
+class ThreadBackgroundQueue;
 
 /**
  * A #BackgroundCommand which defers execution into a new thread.
  */
-class ThreadBackgroundCommand : public BackgroundCommand {
+class ThreadBackgroundCommand
+	: public BackgroundCommand, public SafeLinkIntrusiveListHook
+{
+	friend class ThreadBackgroundQueue;
+
 	Thread thread;
 	InjectEvent defer_finish;
 	Client &client;
 
+	/**
+	 * The #ThreadBackgroundQueue this command was submitted to
+	 * (or nullptr).
+	 */
+	ThreadBackgroundQueue *queue = nullptr;
+
 	/**
 	 * The error thrown by Run().
 	 */
@@ -37,9 +49,21 @@ public:
 		thread.Start();
 	}
 
+	/**
+	 * Like Start(), but the thread may be started later if the
+	 * #ThreadBackgroundQueue has no free slot.
+	 */
+	void Start(ThreadBackgroundQueue &_queue);
+
 	void Cancel() noexcept final;
 
 private:
+	/**
+	 * Called by #ThreadBackgroundQueue when a slot for this
+	 * waiting command has become available.
+	 */
+	void StartQueued() noexcept;
+
 	void _Run() noexcept;
 	void DeferredFinish() noexcept;
 
@@ -57,6 +81,10 @@ protected:
 	 */
 	virtual void SendResponse(Response &response) noexcept = 0;
 
+	/**
+	 * Ask Run() to return as quickly as possible.  This is called
+	 * from the main thread before Cancel() joins the thread.
+	 */
 	virtual void CancelThread() noexcept = 0;
 };
 
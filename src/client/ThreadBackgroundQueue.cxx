@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "ThreadBackgroundQueue.hxx"
+#include "ThreadBackgroundCommand.hxx"
+
+#include <cassert>
+
+ThreadBackgroundQueue::ThreadBackgroundQueue(unsigned _max_running) noexcept
+	:max_running(_max_running) {}
+
+ThreadBackgroundQueue::~ThreadBackgroundQueue() noexcept
+{
+	assert(waiting.empty());
+	assert(n_running == 0);
+}
+
+void
+ThreadBackgroundQueue::Submit(ThreadBackgroundCommand &cmd)
+{
+	if (n_running >= max_running) {
+		waiting.push_back(cmd);
+		return;
+	}
+
+	cmd.Start();
+	++n_running;
+}
+
+void
+ThreadBackgroundQueue::Remove(ThreadBackgroundCommand &cmd) noexcept
+{
+	if (cmd.is_linked()) {
+		/* it was still waiting for a slot */
+		cmd.unlink();
+		return;
+	}
+
+	assert(n_running > 0);
+	--n_running;
+
+	while (!waiting.empty() && n_running < max_running) {
+		auto &next = waiting.pop_front();
+		++n_running;
+
+		/* if the thread cannot be started, StartQueued()
+		   schedules the error response, which will call
+		   Remove() again to free the slot */
+		next.StartQueued();
+	}
+}
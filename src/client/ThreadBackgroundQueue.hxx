@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#ifndef MPD_THREAD_BACKGROUND_QUEUE_HXX
+#define MPD_THREAD_BACKGROUND_QUEUE_HXX
+
+#include "util/IntrusiveList.hxx"
+
+class ThreadBackgroundCommand;
+
+/**
+ * Limits the number of #ThreadBackgroundCommand instances running
+ * at the same time.  Commands submitted while all slots are busy
+ * wait in a FIFO until another one finishes.
+ *
+ * This class is not thread-safe; it is only used from the main
+ * thread.
+ */
+class ThreadBackgroundQueue {
+	IntrusiveList<ThreadBackgroundCommand> waiting;
+
+	const unsigned max_running;
+
+	unsigned n_running = 0;
+
+public:
+	explicit ThreadBackgroundQueue(unsigned _max_running) noexcept;
+
+	~ThreadBackgroundQueue() noexcept;
+
+	ThreadBackgroundQueue(const ThreadBackgroundQueue &) = delete;
+	ThreadBackgroundQueue &operator=(const ThreadBackgroundQueue &) = delete;
+
+	/**
+	 * Start the command's thread now if a slot is free, or else
+	 * enqueue it.
+	 *
+	 * Throws if the thread could not be started.
+	 */
+	void Submit(ThreadBackgroundCommand &cmd);
+
+	/**
+	 * Remove a command from this queue; to be called after its
+	 * thread has been joined or if it was cancelled before its
+	 * thread was started.  This frees its slot for the next
+	 * waiting command.
+	 */
+	void Remove(ThreadBackgroundCommand &cmd) noexcept;
+};
+
+#endif
@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "ThreadedSocket.hxx"
+#include "IOConnection.hxx"
+#include "IOThreads.hxx"
+#include "event/Call.hxx"
+#include "net/UniqueSocketDescriptor.hxx"
+#include "util/SpanCast.hxx"
+
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+ThreadedClientSocket::ThreadedClientSocket(EventLoop &_loop,
+					   ClientIOThread &thread,
+					   UniqueSocketDescriptor &&fd,
+					   ClientSocketHandler &_handler,
+					   std::size_t _max_output_size)
+	:handler(_handler),
+	 inject_event(_loop, BIND_THIS_METHOD(OnInject)),
+	 output_event(_loop, BIND_THIS_METHOD(SubmitOutput)),
+	 resume_event(_loop, BIND_THIS_METHOD(OnResume)),
+	 max_output_size(_max_output_size)
+{
+	/* the socket must be registered inside the I/O thread */
+	BlockingCall(thread.GetEventLoop(), [this, &thread, &fd](){
+		connection = new ClientIOConnection(thread, fd.Release(),
+						    *this);
+	});
+}
+
+ThreadedClientSocket::~ThreadedClientSocket() noexcept
+{
+	Close();
+}
+
+void
+ThreadedClientSocket::Close() noexcept
+{
+	if (connection == nullptr)
+		return;
+
+	{
+		/* detach; the ClientIOConnection will destroy itself
+		   in the I/O thread */
+		const std::scoped_lock lock{connection->mutex};
+		connection->socket = nullptr;
+		connection->inject_event.Schedule();
+	}
+
+	connection = nullptr;
+
+	inject_event.Cancel();
+	output_event.Cancel();
+	resume_event.Cancel();
+}
+
+inline void
+ThreadedClientSocket::TakeReceived() noexcept
+{
+	assert(connection != nullptr);
+
+	auto &received = connection->received;
+	if (received.empty())
+		return;
+
+	/* discard the consumed part of the input buffer */
+	input.erase(0, input_position);
+	input_position = 0;
+
+	if (input.empty())
+		input.swap(received);
+	else {
+		input.append(received);
+		received.clear();
+	}
+
+	if (connection->input_paused) {
+		/* there is room again; let the I/O thread continue
+		   reading */
+		connection->input_paused = false;
+		connection->resume_input = true;
+		connection->inject_event.Schedule();
+	}
+}
+
+inline bool
+ThreadedClientSocket::HandleInput() noexcept
+{
+	while (!input_paused && input_position < input.size()) {
+		const std::span<std::byte> src{
+			reinterpret_cast<std::byte *>(input.data()) + input_position,
+			input.size() - input_position,
+		};
+
+		switch (handler.OnSocketInput(src)) {
+		case ClientSocketHandler::InputResult::MORE:
+			/* cannot happen, because the I/O thread
+			   submits only complete lines */
+			return true;
+
+		case ClientSocketHandler::InputResult::PAUSE:
+			input_paused = true;
+			return true;
+
+		case ClientSocketHandler::InputResult::AGAIN:
+			break;
+
+		case ClientSocketHandler::InputResult::CLOSED:
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void
+ThreadedClientSocket::OnInject() noexcept
+{
+	assert(connection != nullptr);
+
+	std::exception_ptr error;
+	bool closed, output_empty;
+
+	{
+		const std::scoped_lock lock{connection->mutex};
+		error = std::exchange(connection->error, {});
+		closed = connection->closed;
+		output_empty = std::exchange(connection->output_empty, false);
+
+		if (!input_paused)
+			TakeReceived();
+	}
+
+	if (output_empty && output.empty()) {
+		handler.OnSocketOutputEmpty();
+		if (!IsDefined())
+			return;
+	}
+
+	/* handle the lines received before the connection was
+	   closed, just like BufferedSocket does */
+	if (!HandleInput())
+		return;
+
+	if (error)
+		handler.OnSocketError(std::move(error));
+	else if (closed)
+		handler.OnSocketClosed();
+}
+
+void
+ThreadedClientSocket::OnResume() noexcept
+{
+	assert(connection != nullptr);
+
+	{
+		const std::scoped_lock lock{connection->mutex};
+		TakeReceived();
+	}
+
+	HandleInput();
+}
+
+void
+ThreadedClientSocket::ResumeInput() noexcept
+{
+	if (!input_paused)
+		return;
+
+	input_paused = false;
+	resume_event.Schedule();
+}
+
+bool
+ThreadedClientSocket::Write(std::span<const std::byte> src) noexcept
+{
+	if (connection == nullptr)
+		return false;
+
+	if (src.empty())
+		return true;
+
+	if (GetOutputSize() + src.size() > max_output_size) {
+		handler.OnSocketError(std::make_exception_ptr(std::runtime_error("Output buffer is full")));
+		return false;
+	}
+
+	output.append(ToStringView(src));
+	output_event.Schedule();
+	return true;
+}
+
+void
+ThreadedClientSocket::SubmitOutput() noexcept
+{
+	output_event.Cancel();
+
+	if (connection == nullptr || output.empty())
+		return;
+
+	{
+		const std::scoped_lock lock{connection->mutex};
+
+		auto &submitted = connection->submitted;
+		connection->output_size += output.size();
+
+		if (submitted.empty())
+			submitted.swap(output);
+		else
+			submitted.append(output);
+
+		connection->inject_event.Schedule();
+	}
+
+	output.clear();
+}
+
+bool
+ThreadedClientSocket::Flush() noexcept
+{
+	SubmitOutput();
+	return IsDefined();
+}
+
+std::size_t
+ThreadedClientSocket::GetOutputSize() const noexcept
+{
+	std::size_t size = output.size();
+	if (connection != nullptr)
+		size += connection->output_size.load(std::memory_order_relaxed);
+	return size;
+}
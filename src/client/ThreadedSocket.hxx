@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "Socket.hxx"
+#include "event/DeferEvent.hxx"
+#include "event/IdleEvent.hxx"
+#include "event/InjectEvent.hxx"
+
+#include <string>
+
+class UniqueSocketDescriptor;
+class ClientIOThread;
+class ClientIOConnection;
+
+/**
+ * A #ClientSocket whose socket I/O and line splitting is done by a
+ * #ClientIOConnection in a #ClientIOThread.  Only complete lines
+ * are passed to the main thread, and the output is collected during
+ * one #EventLoop iteration and then submitted to the I/O thread in
+ * one piece.
+ */
+class ThreadedClientSocket final : public ClientSocket {
+	friend class ClientIOConnection;
+
+	ClientSocketHandler &handler;
+
+	/**
+	 * The counterpart in the I/O thread; nullptr after Close().
+	 */
+	ClientIOConnection *connection = nullptr;
+
+	/**
+	 * Wakes up the main thread; scheduled by the
+	 * #ClientIOConnection.
+	 */
+	InjectEvent inject_event;
+
+	/**
+	 * Submits #output to the I/O thread.
+	 */
+	IdleEvent output_event;
+
+	/**
+	 * Continues input processing after ResumeInput().
+	 */
+	DeferEvent resume_event;
+
+	/**
+	 * Complete lines taken from the I/O thread.  The first
+	 * #input_position bytes have already been consumed.
+	 */
+	std::string input;
+	std::size_t input_position = 0;
+
+	/**
+	 * Output which has not yet been submitted to the I/O thread.
+	 */
+	std::string output;
+
+	const std::size_t max_output_size;
+
+	/**
+	 * Has the #ClientSocketHandler returned
+	 * InputResult::PAUSE?
+	 */
+	bool input_paused = false;
+
+public:
+	/**
+	 * Throws on error.
+	 */
+	ThreadedClientSocket(EventLoop &_loop, ClientIOThread &thread,
+			     UniqueSocketDescriptor &&fd,
+			     ClientSocketHandler &_handler,
+			     std::size_t _max_output_size);
+
+	~ThreadedClientSocket() noexcept override;
+
+	/* virtual methods from class ClientSocket */
+	bool IsDefined() const noexcept override {
+		return connection != nullptr;
+	}
+
+	void Close() noexcept override;
+
+	void ConsumeInput(std::size_t nbytes) noexcept override {
+		input_position += nbytes;
+	}
+
+	void ResumeInput() noexcept override;
+	bool Write(std::span<const std::byte> src) noexcept override;
+	bool Flush() noexcept override;
+	std::size_t GetOutputSize() const noexcept override;
+
+	std::size_t GetOutputMaxSize() const noexcept override {
+		return max_output_size;
+	}
+
+private:
+	/**
+	 * Take received lines from the #ClientIOConnection.  Caller
+	 * must hold its mutex.
+	 */
+	void TakeReceived() noexcept;
+
+	/**
+	 * Pass #input to the #ClientSocketHandler.
+	 *
+	 * @return false if the socket has been closed
+	 */
+	bool HandleInput() noexcept;
+
+	void OnInject() noexcept;
+	void OnResume() noexcept;
+	void SubmitOutput() noexcept;
+};
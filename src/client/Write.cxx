@@ -2,12 +2,117 @@
 // Copyright The Music Player Daemon Project
 
 #include "Client.hxx"
+#include "Domain.hxx"
+#include "lib/fmt/ExceptionFormatter.hxx"
+#include "util/SpanCast.hxx"
+#include "Log.hxx"
+
+#ifdef ENABLE_ZLIB
+#include "Compressor.hxx"
+#endif
 
 #include <string.h>
 
+#ifdef ENABLE_ZLIB
+
+/**
+ * Send a frame as soon as this many bytes are buffered in the
+ * #ResponseCompressor, even if the response is not yet complete.
+ */
+static constexpr std::size_t MAX_COMPRESSOR_BUFFER = 64 * 1024;
+
+inline bool
+Client::WriteCompressed(std::span<const std::byte> src) noexcept
+{
+	try {
+		compressor->Write(src);
+	} catch (...) {
+		FmtError(client_domain, "[{}] compression failed: {}",
+			 name, std::current_exception());
+		SetExpired();
+		return false;
+	}
+
+	if (compressor->GetBufferedSize() >= MAX_COMPRESSOR_BUFFER)
+		FlushCompressor();
+	else
+		compressor_flush_event.Schedule();
+
+	return !IsExpired();
+}
+
+void
+Client::FlushCompressor() noexcept
+{
+	compressor_flush_event.Cancel();
+
+	if (IsExpired() || !compressor || compressor->IsEmpty())
+		return;
+
+	std::string_view frame;
+
+	try {
+		frame = compressor->Flush();
+	} catch (...) {
+		FmtError(client_domain, "[{}] compression failed: {}",
+			 name, std::current_exception());
+		SetExpired();
+		return;
+	}
+
+	socket->Write(AsBytes(frame));
+}
+
+#endif
+
 bool
 Client::Write(const void *data, size_t length) noexcept
 {
 	/* if the client is going to be closed, do nothing */
-	return !IsExpired() && FullyBufferedSocket::Write(data, length);
+	if (IsExpired())
+		return false;
+
+#ifdef ENABLE_ZLIB
+	if (compressor)
+		return WriteCompressed({(const std::byte *)data, length});
+#endif
+
+	return socket->Write({(const std::byte *)data, length});
+}
+
+std::size_t
+Client::GetOutputSize() const noexcept
+{
+	std::size_t size = socket->GetOutputSize();
+
+#ifdef ENABLE_ZLIB
+	if (compressor)
+		size += compressor->GetBufferedSize();
+#endif
+
+	return size;
+}
+
+void
+Client::FinishResponse() noexcept
+{
+#ifdef ENABLE_ZLIB
+	FlushCompressor();
+
+	if (!protocol_feature.Test(PF_GZIP)) {
+		compressor.reset();
+		return;
+	}
+
+	if (compressor)
+		return;
+
+	try {
+		compressor = std::make_unique<ResponseCompressor>();
+	} catch (...) {
+		FmtError(client_domain, "[{}] failed to enable compression: {}",
+			 name, std::current_exception());
+		SetExpired();
+	}
+#endif
 }
@@ -4,6 +4,7 @@
 #include "config.h"
 #include "AllCommands.hxx"
 #include "CommandError.hxx"
+#include "CommandStats.hxx"
 #include "Request.hxx"
 #include "QueueCommands.hxx"
 #include "TagCommands.hxx"
@@ -36,7 +37,9 @@
 
 #include <fmt/format.h>
 
+#include <array>
 #include <cassert>
+#include <chrono>
 #include <iterator>
 
 #include <string.h>
@@ -65,6 +68,9 @@ handle_commands(Client &client, Request request, Response &response);
 static CommandResult
 handle_not_commands(Client &client, Request request, Response &response);
 
+static CommandResult
+handle_commandstats(Client &client, Request request, Response &response);
+
 /**
  * The command registry.
  *
@@ -73,6 +79,7 @@ handle_not_commands(Client &client, Request request, Response &response);
 static constexpr struct command commands[] = {
 	{ "add", PERMISSION_ADD, 1, 2, handle_add },
 	{ "addid", PERMISSION_ADD, 1, 2, handle_addid },
+	{ "addmulti", PERMISSION_ADD, 1, -1, handle_addmulti },
 	{ "addtagid", PERMISSION_ADD, 3, 3, handle_addtagid },
 	{ "albumart", PERMISSION_READ, 2, 2, handle_album_art },
 	{ "binarylimit", PERMISSION_NONE, 1, 1, handle_binary_limit },
@@ -82,6 +89,7 @@ static constexpr struct command commands[] = {
 	{ "cleartagid", PERMISSION_ADD, 1, 2, handle_cleartagid },
 	{ "close", PERMISSION_NONE, -1, -1, handle_close },
 	{ "commands", PERMISSION_NONE, 0, 0, handle_commands },
+	{ "commandstats", PERMISSION_READ, 0, 1, handle_commandstats },
 	{ "config", PERMISSION_ADMIN, 0, 0, handle_config },
 	{ "consume", PERMISSION_PLAYER, 1, 1, handle_consume },
 #ifdef ENABLE_DATABASE
@@ -212,6 +220,11 @@ static constexpr struct command commands[] = {
 
 static constexpr unsigned num_commands = std::size(commands);
 
+/**
+ * Statistics for each command, indexed like #commands.
+ */
+static std::array<CommandStats, num_commands> command_stats;
+
 [[gnu::pure]]
 static bool
 command_available([[maybe_unused]] const Partition &partition,
@@ -291,6 +304,59 @@ handle_not_commands(Client &client, [[maybe_unused]] Request request, Response &
 	return PrintUnavailableCommands(r, client.GetPermission());
 }
 
+static void
+PrintDuration(Response &r, const char *name,
+	      CommandStats::Duration duration) noexcept
+{
+	r.Fmt("{}: {:.6f}\n", name,
+	      std::chrono::duration<double>(duration).count());
+}
+
+static void
+PrintCommandStats(Response &r, const char *name,
+		  const CommandStats &stats) noexcept
+{
+	r.Fmt("command: {}\n"
+	      "calls: {}\n"
+	      "errors: {}\n"
+	      "bytes: {}\n",
+	      name, stats.GetCalls(), stats.GetErrors(), stats.GetBytes());
+
+	PrintDuration(r, "time_total", stats.GetTotalDuration());
+	PrintDuration(r, "time_p50", stats.GetPercentile(50));
+	PrintDuration(r, "time_p90", stats.GetPercentile(90));
+	PrintDuration(r, "time_p99", stats.GetPercentile(99));
+	PrintDuration(r, "time_max", stats.GetMaxDuration());
+}
+
+static CommandResult
+handle_commandstats(Client &client, Request request, Response &r)
+{
+	if (!request.empty()) {
+		if (!StringIsEqual(request.front(), "reset")) {
+			r.Error(ACK_ERROR_ARG, "Unknown sub command");
+			return CommandResult::ERROR;
+		}
+
+		if ((client.GetPermission() & PERMISSION_ADMIN) == 0) {
+			r.Error(ACK_ERROR_PERMISSION,
+				"you don't have permission for \"commandstats reset\"");
+			return CommandResult::ERROR;
+		}
+
+		for (auto &i : command_stats)
+			i.Reset();
+
+		return CommandResult::OK;
+	}
+
+	for (unsigned i = 0; i < num_commands; ++i)
+		if (command_stats[i].GetCalls() > 0)
+			PrintCommandStats(r, commands[i].cmd, command_stats[i]);
+
+	return CommandResult::OK;
+}
+
 void
 command_init() noexcept
 {
@@ -405,6 +471,10 @@ command_process(Client &client, unsigned num, char *line) noexcept
 		return CommandResult::FINISH;
 	}
 
+	const struct command *cmd = nullptr;
+	std::chrono::steady_clock::time_point start_time;
+	CommandResult result;
+
 	try {
 		/* now parse the arguments (quoted or unquoted) */
 
@@ -427,15 +497,22 @@ command_process(Client &client, unsigned num, char *line) noexcept
 
 		/* look up and invoke the command handler */
 
-		const struct command *cmd =
-			command_checked_lookup(r, client.GetPermission(),
-					       cmd_name, args);
+		cmd = command_checked_lookup(r, client.GetPermission(),
+					     cmd_name, args);
 		if (cmd == nullptr)
 			return CommandResult::ERROR;
 
-		return cmd->handler(client, args, r);
+		start_time = std::chrono::steady_clock::now();
+		result = cmd->handler(client, args, r);
 	} catch (...) {
 		PrintError(r, std::current_exception());
-		return CommandResult::ERROR;
+		result = CommandResult::ERROR;
 	}
+
+	if (cmd != nullptr)
+		command_stats[cmd - commands].Add(std::chrono::steady_clock::now() - start_time,
+						  result == CommandResult::ERROR,
+						  r.GetBytesWritten());
+
+	return result;
 }
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "CommandStats.hxx"
+
+#include <algorithm>
+#include <bit>
+
+using std::chrono::microseconds;
+
+void
+CommandStats::Add(Duration duration, bool error, std::size_t nbytes) noexcept
+{
+	++calls;
+	if (error)
+		++errors;
+
+	bytes += nbytes;
+	total_duration += duration;
+	max_duration = std::max(max_duration, duration);
+
+	const auto us = std::chrono::duration_cast<microseconds>(duration).count();
+	const std::size_t bucket = us > 1
+		? std::bit_width(static_cast<uint_least64_t>(us)) - 1
+		: 0;
+	++buckets[std::min(bucket, N_BUCKETS - 1)];
+}
+
+CommandStats::Duration
+CommandStats::GetPercentile(unsigned p) const noexcept
+{
+	if (calls == 0)
+		return {};
+
+	/* the number of calls which are faster than or equal to
+	   the percentile (rounded up) */
+	const uint_least64_t n = std::max<uint_least64_t>((calls * p + 99) / 100,
+							  1);
+
+	uint_least64_t sum = 0;
+	for (std::size_t i = 0; i < N_BUCKETS - 1; ++i) {
+		sum += buckets[i];
+		if (sum >= n)
+			return std::min<Duration>(microseconds{uint_least64_t{2} << i},
+						  max_duration);
+	}
+
+	return max_duration;
+}
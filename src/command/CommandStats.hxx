@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Counters and a latency histogram for one protocol command (see
+ * command "commandstats").
+ */
+class CommandStats {
+public:
+	using Duration = std::chrono::steady_clock::duration;
+
+private:
+	/**
+	 * Bucket #i counts calls which took less than 2^(i+1)
+	 * microseconds (and at least 2^i microseconds, except for
+	 * bucket 0).  The last bucket counts everything slower.
+	 */
+	static constexpr std::size_t N_BUCKETS = 32;
+
+	std::array<uint_least64_t, N_BUCKETS> buckets{};
+
+	uint_least64_t calls = 0, errors = 0;
+
+	uint_least64_t bytes = 0;
+
+	Duration total_duration{}, max_duration{};
+
+public:
+	void Add(Duration duration, bool error, std::size_t nbytes) noexcept;
+
+	void Reset() noexcept {
+		*this = {};
+	}
+
+	uint_least64_t GetCalls() const noexcept {
+		return calls;
+	}
+
+	uint_least64_t GetErrors() const noexcept {
+		return errors;
+	}
+
+	uint_least64_t GetBytes() const noexcept {
+		return bytes;
+	}
+
+	Duration GetTotalDuration() const noexcept {
+		return total_duration;
+	}
+
+	Duration GetMaxDuration() const noexcept {
+		return max_duration;
+	}
+
+	/**
+	 * Estimate a percentile from the histogram.  The result is
+	 * the upper bound of the bucket containing the percentile,
+	 * i.e. it is accurate up to a factor of two.
+	 *
+	 * @param p the percentile (0..100)
+	 */
+	[[gnu::pure]]
+	Duration GetPercentile(unsigned p) const noexcept;
+};
@@ -5,15 +5,22 @@
 #include "PositionArg.hxx"
 #include "Request.hxx"
 #include "Partition.hxx"
+#include "Instance.hxx"
 #include "client/StringNormalization.hxx"
 #include "db/DatabaseQueue.hxx"
 #include "db/DatabasePlaylist.hxx"
 #include "db/DatabasePrint.hxx"
 #include "db/Count.hxx"
+#include "db/Interface.hxx"
+#include "db/DatabasePlugin.hxx"
 #include "db/Selection.hxx"
+#include "db/cache/QueryCache.hxx"
 #include "protocol/RangeArg.hxx"
 #include "client/Client.hxx"
 #include "client/Response.hxx"
+#include "client/IncrementalBackgroundCommand.hxx"
+#include "client/ThreadBackgroundCommand.hxx"
+#include "tag/Mask.hxx"
 #include "tag/Names.hxx"
 #include "tag/ParseName.hxx"
 #include "util/Exception.hxx"
@@ -23,7 +30,10 @@
 
 #include <fmt/format.h>
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 #include <limits.h> // for UINT_MAX
@@ -137,15 +147,322 @@ ParseDatabaseSelection(Request args, bool fold_case, bool strip_diacritics, Song
 	return selection;
 }
 
+/**
+ * Build a #QueryCache key which describes everything the response
+ * of handle_match() depends on.
+ */
+static std::string
+MakeQueryCacheKey(const DatabaseSelection &selection,
+		  bool fold_case, bool strip_diacritics,
+		  const Response &r)
+{
+	const TagMask tag_mask = r.GetTagMask();
+
+	auto key = fmt::format("{:d}{:d}{:d}{:d} {} {}-{} ",
+			       fold_case, strip_diacritics,
+			       r.ProtocolFeatureEnabled(PF_BINARY_SONGS),
+			       selection.descending, unsigned(selection.sort),
+			       selection.window.start, selection.window.end);
+
+	for (unsigned i = 0; i < TAG_NUM_OF_ITEM_TYPES; ++i)
+		key.push_back(tag_mask.Test(TagType(i)) ? '1' : '0');
+
+	key.push_back(' ');
+	key += selection.filter->ToExpression();
+	return key;
+}
+
+/**
+ * A database query which writes its response to the given
+ * #Response.  It may be called in a worker thread.
+ *
+ * @param cancel if not nullptr, then the query shall be aborted
+ * (with an exception) when this flag gets set, see
+ * DatabaseSelection::cancel
+ */
+using DatabaseQuery = std::function<void(Response &r, Partition &partition,
+					 const SongFilter *filter,
+					 const std::atomic_bool *cancel)>;
+
+/**
+ * Runs a read-only database query in a worker thread, so a slow
+ * query does not block the main loop and other clients (see
+ * #ThreadBackgroundCommand).  The number of concurrent worker
+ * threads is limited by Instance::database_query_queue.  The
+ * response is collected in a buffer and sent to the client when the
+ * query has finished.
+ */
+class DatabaseQueryCommand final : public ThreadBackgroundCommand {
+	Client &client;
+
+	/**
+	 * The command name, used for error messages.
+	 */
+	const char *const command;
+
+	const std::unique_ptr<const SongFilter> filter;
+
+	const DatabaseQuery query;
+
+	std::string buffer;
+
+	/**
+	 * Set by CancelThread() to make the database visitor throw.
+	 */
+	std::atomic_bool cancel{false};
+
+	QueryCache *cache = nullptr;
+	std::string cache_key;
+	uint_least64_t cache_serial;
+
+public:
+	DatabaseQueryCommand(Client &_client, const char *_command,
+			     std::unique_ptr<const SongFilter> &&_filter,
+			     DatabaseQuery &&_query) noexcept
+		:ThreadBackgroundCommand(_client),
+		 client(_client), command(_command),
+		 filter(std::move(_filter)), query(std::move(_query))
+	{
+		++client.GetInstance().n_database_query_threads;
+	}
+
+	~DatabaseQueryCommand() noexcept override {
+		--client.GetInstance().n_database_query_threads;
+	}
+
+	void EnableCache(QueryCache &_cache, std::string &&key) noexcept {
+		cache = &_cache;
+		cache_key = std::move(key);
+		cache_serial = cache->GetSerial();
+	}
+
+protected:
+	void Run() override {
+		Response r(client, 0, buffer);
+		r.SetCommand(command);
+
+		query(r, client.GetPartition(), filter.get(), &cancel);
+
+		if (r.IsBufferOverflow())
+			throw std::runtime_error("Response is too large");
+	}
+
+	void SendResponse(Response &r) noexcept override {
+		r.Write(buffer.data(), buffer.size());
+
+		if (cache != nullptr)
+			cache->Put(std::move(cache_key), std::move(buffer),
+				   cache_serial);
+	}
+
+	void CancelThread() noexcept override {
+		cancel.store(true, std::memory_order_relaxed);
+	}
+};
+
+/**
+ * Can database queries be moved to a #DatabaseQueryCommand?
+ */
+[[gnu::pure]]
+static bool
+CanQueryInThread(const Client &client) noexcept
+{
+	if (client.IsInCommandList())
+		/* going to background would discard the rest of the
+		   command list */
+		return false;
+
+	const auto *db = client.GetDatabase();
+	return db != nullptr && db->GetPlugin().IsThreadSafe();
+}
+
+/**
+ * Run a database query, in a #DatabaseQueryCommand if possible.
+ *
+ * @param cache if not nullptr, then the response is stored in this
+ * #QueryCache with the given key
+ */
+static CommandResult
+RunDatabaseQuery(Client &client, Response &r,
+		 std::unique_ptr<const SongFilter> &&filter,
+		 DatabaseQuery &&query,
+		 QueryCache *cache=nullptr, std::string &&cache_key={})
+{
+	if (CanQueryInThread(client)) {
+		auto cmd = std::make_unique<DatabaseQueryCommand>(client, r.GetCommand(),
+								  std::move(filter),
+								  std::move(query));
+		if (cache != nullptr)
+			cmd->EnableCache(*cache, std::move(cache_key));
+
+		cmd->Start(client.GetInstance().database_query_queue);
+		client.SetBackgroundCommand(std::move(cmd));
+		return CommandResult::BACKGROUND;
+	}
+
+	if (cache == nullptr) {
+		query(r, client.GetPartition(), filter.get(), nullptr);
+		return CommandResult::OK;
+	}
+
+	const auto serial = cache->GetSerial();
+	std::string value;
+	r.StartCapture(value, cache->GetMaxItemSize());
+
+	try {
+		query(r, client.GetPartition(), filter.get(), nullptr);
+	} catch (...) {
+		r.StopCapture();
+		throw;
+	}
+
+	if (r.StopCapture())
+		cache->Put(std::move(cache_key), std::move(value), serial);
+
+	return CommandResult::OK;
+}
+
+/**
+ * Prints a (possibly huge) #DatabaseSelection incrementally, see
+ * #DatabaseSelectionPrinter.  Optionally, the response is stored in
+ * the #QueryCache.
+ */
+class DatabasePrintCommand final : public IncrementalBackgroundCommand {
+	const Database &db;
+
+	/**
+	 * The filter of the #DatabaseSelection or nullptr if it is
+	 * not filtered.
+	 */
+	const std::unique_ptr<const SongFilter> filter;
+
+	DatabaseSelectionPrinter printer;
+
+	QueryCache *cache = nullptr;
+	std::string cache_key, cache_value;
+	uint_least64_t cache_serial;
+
+public:
+	DatabasePrintCommand(Client &_client, const char *_command,
+			     const Database &_db,
+			     std::unique_ptr<const SongFilter> &&_filter,
+			     DatabaseSelectionPrinter &&_printer) noexcept
+		:IncrementalBackgroundCommand(_client, _command),
+		 db(_db), filter(std::move(_filter)),
+		 printer(std::move(_printer)) {}
+
+	void EnableCache(QueryCache &_cache, std::string &&key) noexcept {
+		cache = &_cache;
+		cache_key = std::move(key);
+		cache_serial = cache->GetSerial();
+	}
+
+protected:
+	bool Generate(Response &r) override {
+		if (cache != nullptr)
+			r.StartCapture(cache_value, cache->GetMaxItemSize());
+
+		bool finished = false;
+
+		try {
+			while (!ShouldSuspend()) {
+				if (!printer.PrintNext(r, db, filter.get())) {
+					finished = true;
+					break;
+				}
+			}
+		} catch (...) {
+			r.StopCapture();
+			throw;
+		}
+
+		if (cache != nullptr && !r.StopCapture()) {
+			/* too large for the cache: stop capturing */
+			cache = nullptr;
+			cache_value = {};
+		}
+
+		if (finished && cache != nullptr)
+			cache->Put(std::move(cache_key), std::move(cache_value),
+				   cache_serial);
+
+		return finished;
+	}
+};
+
+/**
+ * Print the result of a #DatabaseSelection.  Large results are
+ * printed incrementally by a #DatabasePrintCommand if possible;
+ * everything else is done by a #DatabaseQueryCommand.
+ *
+ * @param filter the #SongFilter referenced by the selection (may be
+ * moved)
+ * @param cache if not nullptr, then the response is stored in this
+ * #QueryCache with the given key
+ */
+static CommandResult
+PrintDatabaseSelection(Client &client, Response &r,
+		       const DatabaseSelection &selection, SongFilter &&filter,
+		       bool full,
+		       QueryCache *cache=nullptr, std::string &&cache_key={})
+{
+	std::unique_ptr<const SongFilter> owned_filter;
+
+	if (DatabaseSelectionPrinter::CanPrint(selection)) {
+		const Database &db = client.GetDatabaseOrThrow();
+		DatabaseSelectionPrinter printer(db, selection, full, false);
+		if (!printer.IsEmpty()) {
+			if (selection.filter != nullptr)
+				owned_filter = std::make_unique<const SongFilter>(std::move(filter));
+
+			auto cmd = std::make_unique<DatabasePrintCommand>(client, r.GetCommand(),
+									  db, std::move(owned_filter),
+									  std::move(printer));
+			if (cache != nullptr)
+				cmd->EnableCache(*cache, std::move(cache_key));
+
+			return IncrementalBackgroundCommand::Start(std::move(cmd), r);
+		}
+	}
+
+	/* the result needs to be collected completely (e.g. for
+	   sorting); do that in a worker thread */
+	if (selection.filter != nullptr)
+		owned_filter = std::make_unique<const SongFilter>(std::move(filter));
+
+	return RunDatabaseQuery(client, r, std::move(owned_filter),
+				[selection, full](Response &_r, Partition &partition,
+						  const SongFilter *_filter,
+						  const std::atomic_bool *cancel){
+					DatabaseSelection s(selection);
+					s.filter = _filter;
+					s.cancel = cancel;
+					db_selection_print(_r, partition,
+							   s, full, false);
+				},
+				cache, std::move(cache_key));
+}
+
 static CommandResult
 handle_match(Client &client, Request args, Response &r, bool fold_case, bool strip_diacritics)
 {
 	SongFilter filter;
 	const auto selection = ParseDatabaseSelection(args, fold_case, strip_diacritics, filter);
 
-	db_selection_print(r, client.GetPartition(),
-			   selection, true, false);
-	return CommandResult::OK;
+	auto *cache = client.GetInstance().query_cache.get();
+	if (cache == nullptr)
+		return PrintDatabaseSelection(client, r, selection,
+					      std::move(filter), true);
+
+	auto key = MakeQueryCacheKey(selection, fold_case, strip_diacritics,
+				     r);
+	if (const auto *value = cache->Get(key)) {
+		r.Write(value->data(), value->size());
+		return CommandResult::OK;
+	}
+
+	return PrintDatabaseSelection(client, r, selection, std::move(filter),
+				      true, cache, std::move(key));
 }
 
 CommandResult
@@ -255,8 +572,14 @@ handle_count_internal(Client &client, Request args, Response &r, bool fold_case,
 		filter.Optimize();
 	}
 
-	PrintSongCount(r, client.GetPartition(), "", &filter, group);
-	return CommandResult::OK;
+	return RunDatabaseQuery(client, r,
+				std::make_unique<const SongFilter>(std::move(filter)),
+				[group](Response &_r, Partition &partition,
+					const SongFilter *_filter,
+					const std::atomic_bool *cancel){
+					PrintSongCount(_r, partition, "", _filter, group,
+						       cancel);
+				});
 }
 
 CommandResult
@@ -278,10 +601,8 @@ handle_listall(Client &client, Request args, Response &r)
 	/* default is root directory */
 	const auto uri = args.GetOptional(0, "");
 
-	db_selection_print(r, client.GetPartition(),
-			   DatabaseSelection(uri, true),
-			   false, false);
-	return CommandResult::OK;
+	return PrintDatabaseSelection(client, r, DatabaseSelection(uri, true),
+				      {}, false);
 }
 
 static CommandResult
@@ -301,8 +622,13 @@ handle_list_file(Client &client, Request args, Response &r)
 		filter->Optimize();
 	}
 
-	PrintSongUris(r, client.GetPartition(), filter.get());
-	return CommandResult::OK;
+	return RunDatabaseQuery(client, r, std::move(filter),
+				[](Response &_r, Partition &partition,
+				   const SongFilter *_filter,
+				   const std::atomic_bool *cancel){
+					PrintSongUris(_r, partition, _filter,
+						      cancel);
+				});
 }
 
 CommandResult
@@ -384,11 +710,16 @@ handle_list(Client &client, Request args, Response &r)
 		filter->Optimize();
 	}
 
-	PrintUniqueTags(r, client.GetPartition(),
-			{&tag_types.front(), tag_types.size()},
-			filter.get(),
-			window);
-	return CommandResult::OK;
+	return RunDatabaseQuery(client, r, std::move(filter),
+				[tag_types=std::move(tag_types), window](Response &_r,
+									 Partition &partition,
+									 const SongFilter *_filter,
+									 const std::atomic_bool *cancel){
+					PrintUniqueTags(_r, partition,
+							tag_types,
+							_filter,
+							window, cancel);
+				});
 }
 
 CommandResult
@@ -397,8 +728,6 @@ handle_listallinfo(Client &client, Request args, Response &r)
 	/* default is root directory */
 	const auto uri = args.GetOptional(0, "");
 
-	db_selection_print(r, client.GetPartition(),
-			   DatabaseSelection(uri, true),
-			   true, false);
-	return CommandResult::OK;
+	return PrintDatabaseSelection(client, r, DatabaseSelection(uri, true),
+				      {}, true);
 }
@@ -14,8 +14,13 @@
 #include "tag/Handler.hxx"
 #include "tag/Generic.hxx"
 #include "TagAny.hxx"
+#include "CoverArt.hxx"
 #include "db/Features.hxx" // for ENABLE_DATABASE
 #include "db/Interface.hxx"
+#include "db/LightDirectory.hxx"
+#include "db/Selection.hxx"
+#include "db/cache/PictureCache.hxx"
+#include "Instance.hxx"
 #include "song/LightSong.hxx"
 #include "storage/StorageInterface.hxx"
 #include "fs/AllocatedPath.hxx"
@@ -32,7 +37,7 @@
 
 #include <algorithm>
 #include <cassert>
-#include <array>
+#include <optional>
 
 using std::string_view_literals::operator""sv;
 
@@ -130,21 +135,35 @@ handle_read_comments(Client &client, Request args, Response &r)
 }
 
 /**
- * Searches for the files listed in #artnames in the UTF8 folder
+ * Searches for the files listed in #cover_art_names in the UTF8 folder
  * URI #directory. This can be a local path or protocol-based
  * URI that #InputStream supports. Returns the first successfully
  * opened file or #nullptr on failure.
+ *
+ * @param cover the file name recorded in the database (tried
+ * first); empty if unknown
  */
 static InputStreamPtr
-find_stream_art(std::string_view directory, Mutex &mutex)
+find_stream_art(std::string_view directory, std::string_view cover,
+		Mutex &mutex)
 {
-	static constexpr auto art_names = std::array {
-		"cover.png",
-		"cover.jpg",
-		"cover.webp",
-	};
+	if (!cover.empty()) {
+		/* the database knows the file name */
+		std::string art_file = PathTraitsUTF8::Build(directory, cover);
 
-	for(const auto name : art_names) {
+		try {
+			return InputStream::OpenReady(art_file, mutex);
+		} catch (...) {
+			auto e = std::current_exception();
+			if (!IsFileNotFound(e))
+				LogError(e);
+
+			/* the database is stale; fall back to
+			   probing all names */
+		}
+	}
+
+	for (const auto name : cover_art_names) {
 		std::string art_file = PathTraitsUTF8::Build(directory, name);
 
 		try {
@@ -158,9 +177,68 @@ find_stream_art(std::string_view directory, Mutex &mutex)
 	return nullptr;
 }
 
+#ifdef ENABLE_DATABASE
+
+[[gnu::pure]]
+static PictureCache *
+GetPictureCache(const Client &client) noexcept
+{
+	return client.GetInstance().picture_cache.get();
+}
+
+/**
+ * Send a chunk of a picture which was loaded from the
+ * #PictureCache.
+ */
+static CommandResult
+SendCachedPicture(Response &r, const CachedPicture &picture, size_t offset)
+{
+	auto buffer = picture.GetData();
+	if (offset > buffer.size()) {
+		r.Error(ACK_ERROR_ARG, "Offset too large");
+		return CommandResult::ERROR;
+	}
+
+	r.Fmt("size: {}\n"sv, buffer.size());
+
+	if (!picture.mime_type.empty())
+		r.Fmt("type: {}\n", picture.mime_type);
+
+	buffer = buffer.subspan(offset);
+
+	const std::size_t binary_limit = r.GetClient().binary_limit;
+	if (buffer.size() > binary_limit)
+		buffer = buffer.first(binary_limit);
+
+	r.WriteBinary(buffer);
+	return CommandResult::OK;
+}
+
+/**
+ * Build the #PictureCache key for the album art of the given
+ * directory.
+ */
+static std::string
+MakeAlbumArtCacheKey(std::string_view directory)
+{
+	return fmt::format("albumart\n{}", directory);
+}
+
+#endif
+
+/**
+ * @param cache if not nullptr, then the file will be added to this
+ * #PictureCache; the caller is responsible for looking it up there
+ * before calling this function
+ * @param cache_key the #PictureCache key for this file (only used
+ * if #cache is not nullptr)
+ */
 static CommandResult
 read_stream_art(Response &r, const std::string_view art_directory,
-		size_t offset)
+		size_t offset,
+		std::string_view cover={},
+		[[maybe_unused]] PictureCache *cache=nullptr,
+		[[maybe_unused]] std::string_view cache_key={})
 {
 	// TODO: eliminate this const_cast
 	auto &client = const_cast<Client &>(r.GetClient());
@@ -168,9 +246,9 @@ read_stream_art(Response &r, const std::string_view art_directory,
 	/* to avoid repeating the search for each chunk request by the
 	   same client, use the #LastInputStream class to cache the
 	   #InputStream instance */
-	auto *is = client.last_album_art.Open(art_directory, [](std::string_view directory,
-								Mutex &mutex){
-		return find_stream_art(directory, mutex);
+	auto *is = client.last_album_art.Open(art_directory, [cover](std::string_view directory,
+								     Mutex &mutex){
+		return find_stream_art(directory, cover, mutex);
 	});
 
 	if (is == nullptr) {
@@ -184,6 +262,16 @@ read_stream_art(Response &r, const std::string_view art_directory,
 
 	const offset_type art_file_size = is->GetSize();
 
+#ifdef ENABLE_DATABASE
+	/* the file is added to the #PictureCache while the client
+	   requests it chunk by chunk; reading it all at once here
+	   would block the main thread */
+	if (cache != nullptr && offset == 0 &&
+	    art_file_size <= cache->GetMaxItemSize())
+		client.album_art_filler.Start(*cache, cache_key, {},
+					      art_file_size);
+#endif
+
 	if (offset > art_file_size) {
 		r.Error(ACK_ERROR_ARG, "Offset too large");
 		return CommandResult::ERROR;
@@ -214,6 +302,12 @@ read_stream_art(Response &r, const std::string_view art_directory,
 			read_size += is->Read(lock, {buffer.get() + read_size, buffer_size - read_size});
 	}
 
+#ifdef ENABLE_DATABASE
+	if (cache != nullptr)
+		client.album_art_filler.Add(*cache, cache_key, offset,
+					    {buffer.get(), read_size});
+#endif
+
 	r.Fmt("size: {}\n", art_file_size);
 
 	r.WriteBinary({buffer.get(), read_size});
@@ -227,37 +321,123 @@ read_stream_art(Response &r, const std::string_view art_directory,
  * Attempt to locate the "real" directory where the given song is
  * stored.  This attempts to resolve "virtual" directories/songs,
  * e.g. expanded CUE sheet contents.
+ *
+ * @return the number of levels to go up from the song's
+ * (virtual) parent directory
  */
 [[gnu::pure]]
-static std::string_view
-RealDirectoryOfSong(Client &client, const char *song_uri,
-		    std::string_view directory_uri) noexcept
+static unsigned
+RealDirectoryLevelsOfSong(Client &client, const char *song_uri) noexcept
 try {
 	const auto *db = client.GetDatabase();
 	if (db == nullptr)
-		return directory_uri;
+		return 0;
 
 	const auto *song = db->GetSong(song_uri);
 	if (song == nullptr)
-		return directory_uri;
+		return 0;
 
 	AtScopeExit(db, song) { db->ReturnSong(song); };
 
 	if (song->real_uri == nullptr)
-		return directory_uri;
+		return 0;
 
 	const char *real_uri = song->real_uri;
 
 	/* this is a simplification which is just enough for CUE
 	   sheets (but may be incomplete): for each "../", go one
 	   level up */
+	unsigned levels = 0;
 	while ((real_uri = StringAfterPrefix(real_uri, "../")) != nullptr)
-		directory_uri = PathTraitsUTF8::GetParent(directory_uri);
+		++levels;
 
-	return directory_uri;
+	return levels;
 } catch (...) {
 	/* ignore all exceptions from Database::GetSong() */
-	return directory_uri;
+	return 0;
+}
+
+/**
+ * Like PathTraitsUTF8::GetParent(), but for database URIs: the
+ * parent of a top-level item is the root directory (an empty
+ * string).
+ */
+[[gnu::pure]]
+static std::string_view
+GetDatabaseParent(std::string_view uri) noexcept
+{
+	const auto slash = uri.rfind('/');
+	return slash == uri.npos
+		? std::string_view{}
+		: uri.substr(0, slash);
+}
+
+/**
+ * Look up the album art file name which was recorded in the
+ * database by the last update (see Directory::cover).
+ *
+ * @return the file name, an empty string if the directory has no
+ * album art file, or std::nullopt if that is not known
+ */
+static std::optional<std::string>
+LookupDirectoryCover(Client &client, std::string_view directory_uri) noexcept
+try {
+	if (directory_uri.empty())
+		/* the root directory is not visited by
+		   Database::Visit() */
+		return std::nullopt;
+
+	const auto *db = client.GetDatabase();
+	if (db == nullptr)
+		return std::nullopt;
+
+	std::optional<std::string> result;
+
+	const std::string parent{GetDatabaseParent(directory_uri)};
+	const DatabaseSelection selection(parent.c_str(), false);
+	db->Visit(selection, [directory_uri, &result](const LightDirectory &directory){
+		if (directory.cover != nullptr &&
+		    directory_uri == directory.GetPath())
+			result = directory.cover;
+	}, VisitSong{});
+
+	return result;
+} catch (...) {
+	/* ignore all exceptions from Database::Visit(); fall back
+	   to probing the storage */
+	return std::nullopt;
+}
+
+/**
+ * Look up the modification time of a song in the database.
+ *
+ * @return the modification time or std::nullopt if this is not a
+ * database song (or if it has no known modification time)
+ */
+[[gnu::pure]]
+static std::optional<PictureCache::TimePoint>
+GetDatabaseSongTime(Client &client, const char *uri) noexcept
+try {
+	if (PathTraitsUTF8::IsAbsoluteOrHasScheme(uri))
+		return std::nullopt;
+
+	const auto *db = client.GetDatabase();
+	if (db == nullptr)
+		return std::nullopt;
+
+	const auto *song = db->GetSong(uri);
+	if (song == nullptr)
+		return std::nullopt;
+
+	AtScopeExit(db, song) { db->ReturnSong(song); };
+
+	if (song->mtime == PictureCache::TimePoint::min())
+		return std::nullopt;
+
+	return song->mtime;
+} catch (...) {
+	/* ignore all exceptions from Database::GetSong() */
+	return std::nullopt;
 }
 
 static CommandResult
@@ -270,12 +450,42 @@ read_db_art(Client &client, Response &r, const char *uri, const uint64_t offset)
 	}
 	std::string uri2 = storage->MapUTF8(uri);
 
-	std::string_view directory_uri =
-		RealDirectoryOfSong(client,
-				    uri,
-				    PathTraitsUTF8::GetParent(uri2.c_str()));
+	std::string_view directory_uri = PathTraitsUTF8::GetParent(uri2.c_str());
+	std::string_view db_directory_uri = GetDatabaseParent(uri);
+
+	for (unsigned levels = RealDirectoryLevelsOfSong(client, uri);
+	     levels > 0; --levels) {
+		directory_uri = PathTraitsUTF8::GetParent(directory_uri);
+		db_directory_uri = GetDatabaseParent(db_directory_uri);
+	}
+
+	/* album art files are not validated with their modification
+	   time (that would require opening them); the whole
+	   #PictureCache is discarded when the database changes */
+	PictureCache *const cache = GetPictureCache(client);
+	std::string cache_key;
+	if (cache != nullptr) {
+		cache_key = MakeAlbumArtCacheKey(directory_uri);
+		if (const auto *picture = cache->Get(cache_key, {}))
+			return SendCachedPicture(r, *picture, offset);
+	}
+
+	/* if the database update has recorded the album art file of
+	   this directory, we don't need to probe the storage; this is
+	   only needed for opening a new stream, not for subsequent
+	   chunk requests served by #last_album_art */
+	std::optional<std::string> cover;
+	if (!client.last_album_art.IsOpen(directory_uri))
+		cover = LookupDirectoryCover(client, db_directory_uri);
+
+	if (cover && cover->empty()) {
+		r.Error(ACK_ERROR_NO_EXIST, "No file exists");
+		return CommandResult::ERROR;
+	}
 
-	return read_stream_art(r, directory_uri, offset);
+	return read_stream_art(r, directory_uri, offset,
+			       cover ? std::string_view{*cover} : std::string_view{},
+			       cache, cache_key);
 }
 #endif
 
@@ -321,10 +531,25 @@ class PrintPictureHandler final : public NullTagHandler {
 
 	bool bad_offset = false;
 
+	/**
+	 * If not nullptr, then a copy of the picture is stored here
+	 * (unless it is larger than #max_capture_size).
+	 */
+	CachedPicture *const capture;
+
+	const std::size_t max_capture_size;
+
 public:
-	PrintPictureHandler(Response &_response, size_t _offset) noexcept
+	PrintPictureHandler(Response &_response, size_t _offset,
+			    CachedPicture *_capture=nullptr,
+			    std::size_t _max_capture_size=0) noexcept
 		:NullTagHandler(WANT_PICTURE), response(_response),
-		 offset(_offset) {}
+		 offset(_offset),
+		 capture(_capture), max_capture_size(_max_capture_size) {}
+
+	bool IsCaptured() const noexcept {
+		return capture != nullptr && capture->data != nullptr;
+	}
 
 	void RethrowError() const {
 		if (bad_offset)
@@ -339,6 +564,12 @@ public:
 
 		found = true;
 
+		if (capture != nullptr && buffer.size() <= max_capture_size) {
+			if (mime_type.data() != nullptr)
+				capture->mime_type = mime_type;
+			capture->data = buffer;
+		}
+
 		if (offset > buffer.size()) {
 			bad_offset = true;
 			return;
@@ -367,6 +598,33 @@ handle_read_picture(Client &client, Request args, Response &r)
 	const char *const uri = args.front();
 	const size_t offset = args.ParseUnsigned(1);
 
+#ifdef ENABLE_DATABASE
+	if (auto *cache = GetPictureCache(client)) {
+		/* only songs from the database are cached, because
+		   only those have a cheap modification time lookup */
+		if (const auto mtime = GetDatabaseSongTime(client, uri)) {
+			std::string key = fmt::format("readpicture\n{}", uri);
+			if (const auto *picture = cache->Get(key, *mtime)) {
+				if (offset > picture->data.size())
+					throw ProtocolError(ACK_ERROR_ARG,
+							    "Bad file offset");
+
+				return SendCachedPicture(r, *picture, offset);
+			}
+
+			CachedPicture capture;
+			PrintPictureHandler handler(r, offset, &capture,
+						    cache->GetMaxItemSize());
+			TagScanAny(client, uri, handler);
+			if (handler.IsCaptured())
+				cache->Put(std::move(key), *mtime,
+					   std::move(capture));
+			handler.RethrowError();
+			return CommandResult::OK;
+		}
+	}
+#endif
+
 	PrintPictureHandler handler(r, offset);
 	TagScanAny(client, uri, handler);
 	handler.RethrowError();
@@ -99,10 +99,9 @@ handle_pause(Client &client, Request args, [[maybe_unused]] Response &r)
 	return CommandResult::OK;
 }
 
-CommandResult
-handle_status(Client &client, [[maybe_unused]] Request args, Response &r)
+void
+PrintStatus(Response &r, Partition &partition)
 {
-	auto &partition = client.GetPartition();
 	auto &pc = partition.pc;
 
 	const char *state = nullptr;
@@ -207,7 +206,12 @@ handle_status(Client &client, [[maybe_unused]] Request args, Response &r)
 		r.Fmt(COMMAND_STATUS_NEXTSONG ": {}\n"
 		      COMMAND_STATUS_NEXTSONGID ": {}\n",
 		      song, playlist.PositionToId(song));
+}
 
+CommandResult
+handle_status(Client &client, [[maybe_unused]] Request args, Response &r)
+{
+	PrintStatus(r, client.GetPartition());
 	return CommandResult::OK;
 }
 
@@ -9,6 +9,13 @@
 class Client;
 class Request;
 class Response;
+struct Partition;
+
+/**
+ * Print the response of the "status" command.
+ */
+void
+PrintStatus(Response &r, Partition &partition);
 
 CommandResult
 handle_play(Client &client, Request request, Response &response);
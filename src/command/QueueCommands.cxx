@@ -4,6 +4,7 @@
 #include "QueueCommands.hxx"
 #include "PositionArg.hxx"
 #include "Request.hxx"
+#include "protocol/Ack.hxx"
 #include "protocol/RangeArg.hxx"
 #include "db/Features.hxx" // for ENABLE_DATABASE
 #include "db/DatabaseQueue.hxx"
@@ -16,8 +17,11 @@
 #include "queue/Playlist.hxx"
 #include "queue/Selection.hxx"
 #include "PlaylistPrint.hxx"
+#include "PlaylistError.hxx"
+#include "queue/Print.hxx"
 #include "client/Client.hxx"
 #include "client/Response.hxx"
+#include "client/IncrementalBackgroundCommand.hxx"
 #include "Partition.hxx"
 #include "Instance.hxx"
 #include "BulkEdit.hxx"
@@ -27,6 +31,7 @@
 
 #include <fmt/format.h>
 
+#include <cassert>
 #include <limits>
 
 static void
@@ -50,12 +55,15 @@ AddDatabaseSelection(Partition &partition, const char *uri)
 
 #endif
 
-CommandResult
-handle_add(Client &client, Request args, [[maybe_unused]] Response &r)
+/**
+ * Add a song, a remote URI or a database directory (recursively) to
+ * the queue.
+ *
+ * Throws on error.
+ */
+static void
+AddUriOrDirectory(Client &client, const char *uri)
 {
-	auto &partition = client.GetPartition();
-
-	const char *uri = args.front();
 	if (StringIsEqual(uri, "/"))
 		/* this URI is malformed, but some clients are buggy
 		   and use "add /" to add the whole database, which
@@ -64,11 +72,6 @@ handle_add(Client &client, Request args, [[maybe_unused]] Response &r)
 		   here */
 		uri = "";
 
-	const auto old_size = partition.playlist.GetLength();
-	const unsigned position = args.size() > 1
-		? ParseInsertPosition(args[1], partition.playlist)
-		: old_size;
-
 	const auto located_uri = LocateUri(UriPluginKind::INPUT, uri,
 					   &client
 #ifdef ENABLE_DATABASE
@@ -87,13 +90,26 @@ handle_add(Client &client, Request args, [[maybe_unused]] Response &r)
 
 	case LocatedUri::Type::RELATIVE:
 #ifdef ENABLE_DATABASE
-		AddDatabaseSelection(partition, located_uri.canonical_uri);
+		AddDatabaseSelection(client.GetPartition(),
+				     located_uri.canonical_uri);
 		break;
 #else
-		r.Error(ACK_ERROR_NO_EXIST, "No database");
-		return CommandResult::ERROR;
+		throw ProtocolError(ACK_ERROR_NO_EXIST, "No database");
 #endif
 	}
+}
+
+CommandResult
+handle_add(Client &client, Request args, [[maybe_unused]] Response &r)
+{
+	auto &partition = client.GetPartition();
+
+	const auto old_size = partition.playlist.GetLength();
+	const unsigned position = args.size() > 1
+		? ParseInsertPosition(args[1], partition.playlist)
+		: old_size;
+
+	AddUriOrDirectory(client, args.front());
 
 	if (position < old_size) {
 		const unsigned new_size = partition.playlist.GetLength();
@@ -109,6 +125,42 @@ handle_add(Client &client, Request args, [[maybe_unused]] Response &r)
 	return CommandResult::OK;
 }
 
+CommandResult
+handle_addmulti(Client &client, Request args, [[maybe_unused]] Response &r)
+{
+	auto &partition = client.GetPartition();
+
+	/* resolve all songs at once before modifying the queue */
+	const SongLoader loader(client);
+	auto songs = loader.LoadSongs(args);
+	assert(songs.size() == args.size());
+
+	const ScopeBulkEdit bulk_edit(partition);
+
+	for (std::size_t i = 0; i < songs.size(); ++i) {
+		auto &song = songs[i];
+		if (!song) {
+			/* not a song (probably a directory) or an
+			   error; the single-URI code path handles
+			   directories and generates the error
+			   message */
+			AddUriOrDirectory(client, args[i]);
+			continue;
+		}
+
+		std::string remote_uri;
+		if (!song->IsInDatabase() && song->IsRemote())
+			remote_uri = song->GetURI();
+
+		partition.playlist.AppendSong(partition.pc, std::move(*song));
+
+		if (!remote_uri.empty())
+			client.GetInstance().LookupRemoteTag(remote_uri.c_str());
+	}
+
+	return CommandResult::OK;
+}
+
 CommandResult
 handle_addid(Client &client, Request args, Response &r)
 {
@@ -248,13 +300,66 @@ handle_plchangesposid(Client &client, Request args, Response &r)
 	return CommandResult::OK;
 }
 
+/**
+ * Prints a range of the queue incrementally.  If the queue gets
+ * modified by another client between two slices, the response
+ * would not be a consistent snapshot (songs could be skipped or
+ * repeated), so the command fails.
+ */
+class QueuePrintCommand final : public IncrementalBackgroundCommand {
+	unsigned position;
+	const unsigned end;
+
+	/**
+	 * The queue version when this command was started.
+	 */
+	const uint32_t version;
+
+public:
+	QueuePrintCommand(Client &_client, const char *_command,
+			  RangeArg range) noexcept
+		:IncrementalBackgroundCommand(_client, _command),
+		 position(range.start), end(range.end),
+		 version(_client.GetPlaylist().queue.version) {}
+
+protected:
+	bool Generate(Response &r) override {
+		const Queue &queue = GetClient().GetPlaylist().queue;
+		if (queue.version != version)
+			throw ProtocolError(ACK_ERROR_PLAYER_SYNC,
+					    "Queue was modified while printing");
+
+		assert(end <= queue.GetLength());
+
+		while (position < end && !ShouldSuspend()) {
+			queue_print_info(r, queue, position, position + 1);
+			++position;
+		}
+
+		return position >= end;
+	}
+};
+
+static CommandResult
+PrintQueue(Client &client, Response &r, RangeArg range)
+{
+	if (!range.CheckClip(client.GetPlaylist().queue.GetLength()))
+		throw PlaylistError::BadRange();
+
+	if (range.IsEmpty())
+		return CommandResult::OK;
+
+	auto cmd = std::make_unique<QueuePrintCommand>(client, r.GetCommand(),
+						       range);
+	return IncrementalBackgroundCommand::Start(std::move(cmd), r);
+}
+
 CommandResult
 handle_playlistinfo(Client &client, Request args, Response &r)
 {
 	RangeArg range = args.ParseOptional(0, RangeArg::All());
 
-	playlist_print_info(r, client.GetPlaylist(), range);
-	return CommandResult::OK;
+	return PrintQueue(client, r, range);
 }
 
 CommandResult
@@ -264,7 +369,7 @@ handle_playlistid(Client &client, Request args, Response &r)
 		unsigned id = args.ParseUnsigned(0);
 		playlist_print_id(r, client.GetPlaylist(), id);
 	} else {
-		playlist_print_info(r, client.GetPlaylist(), RangeArg::All());
+		return PrintQueue(client, r, RangeArg::All());
 	}
 
 	return CommandResult::OK;
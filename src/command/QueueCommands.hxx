@@ -13,6 +13,9 @@ class Response;
 CommandResult
 handle_add(Client &client, Request request, Response &response);
 
+CommandResult
+handle_addmulti(Client &client, Request request, Response &response);
+
 CommandResult
 handle_addid(Client &client, Request request, Response &response);
 
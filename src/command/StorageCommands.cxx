@@ -199,6 +199,7 @@ handle_mount(Client &client, Request args, Response &r)
 
 		// TODO: call Instance::OnDatabaseModified()?
 		// TODO: trigger database update?
+		instance.InvalidateDatabaseCaches();
 		instance.EmitIdle(IDLE_DATABASE);
 
 		if (need_update) {
@@ -233,6 +234,13 @@ handle_unmount(Client &client, Request args, Response &r)
 	}
 
 #ifdef ENABLE_DATABASE
+	if (instance.n_database_query_threads > 0) {
+		/* a worker thread may be visiting the mounted
+		   database right now */
+		r.Error(ACK_ERROR_UNKNOWN, "Database is busy");
+		return CommandResult::ERROR;
+	}
+
 	if (instance.update != nullptr)
 		/* ensure that no database update will attempt to work
 		   with the database/storage instances we're about to
@@ -240,9 +248,11 @@ handle_unmount(Client &client, Request args, Response &r)
 		instance.update->CancelMount(local_uri);
 
 	if (auto *db = dynamic_cast<SimpleDatabase *>(instance.GetDatabase())) {
-		if (db->Unmount(local_uri))
+		if (db->Unmount(local_uri)) {
 			// TODO: call Instance::OnDatabaseModified()?
+			instance.InvalidateDatabaseCaches();
 			instance.EmitIdle(IDLE_DATABASE);
+		}
 	}
 #endif
 
@@ -42,6 +42,7 @@ enum class ConfigOption {
 	VOLUME_NORMALIZATION,
 	SAMPLERATE_CONVERTER,
 	AUDIO_BUFFER_SIZE,
+	AUDIO_CHUNK_SIZE,
 	BUFFER_BEFORE_PLAY,
 	HTTP_PROXY_HOST,
 	HTTP_PROXY_PORT,
@@ -52,6 +53,7 @@ enum class ConfigOption {
 	MAX_PLAYLIST_LENGTH,
 	MAX_COMMAND_LIST_SIZE,
 	MAX_OUTPUT_BUFFER_SIZE,
+	CLIENT_THREADS,
 	FS_CHARSET,
 	ID3V1_ENCODING,
 	METADATA_TO_USE,
@@ -75,6 +77,8 @@ enum class ConfigBlockOption {
 	RESAMPLER,
 	AUDIO_FILTER,
 	DATABASE,
+	QUERY_CACHE,
+	PICTURE_CACHE,
 	NEIGHBORS,
 	PARTITION,
 	MAX
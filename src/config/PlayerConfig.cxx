@@ -10,32 +10,55 @@
 #include "Log.hxx"
 #include "MusicChunk.hxx"
 
-static constexpr
-size_t MIN_BUFFER_SIZE = std::max(CHUNK_SIZE * 32,
-				  64 * KILOBYTE);
+static_assert(PlayerConfig::DEFAULT_CHUNK_SIZE >= CHUNK_SIZE);
+
+static constexpr size_t MAX_CHUNK_SIZE = MEGABYTE;
+
+static size_t
+GetChunkSize(const ConfigData &config)
+{
+	return config.With(ConfigOption::AUDIO_CHUNK_SIZE, [](const char *s){
+		if (s == nullptr)
+			return PlayerConfig::DEFAULT_CHUNK_SIZE;
+
+		size_t result = ParseSize(s, KILOBYTE);
+		if (result < CHUNK_SIZE || result > MAX_CHUNK_SIZE)
+			throw FmtRuntimeError("chunk size {:?} is not between "
+					      "{} and {} bytes",
+					      s, CHUNK_SIZE, MAX_CHUNK_SIZE);
+
+		return result;
+	});
+}
 
 static unsigned
-GetBufferChunks(const ConfigData &config)
+GetBufferChunks(const ConfigData &config, size_t chunk_size)
 {
+	const size_t min_buffer_size = std::max(chunk_size * 32,
+						64 * KILOBYTE);
+
 	size_t buffer_size = PlayerConfig::DEFAULT_BUFFER_SIZE;
 	if (auto *param = config.GetParam(ConfigOption::AUDIO_BUFFER_SIZE)) {
-		buffer_size = param->With([](const char *s){
+		buffer_size = param->With([min_buffer_size](const char *s){
 			size_t result = ParseSize(s, KILOBYTE);
 			if (result <= 0)
 				throw FmtRuntimeError("buffer size {:?} is not a "
 						      "positive integer", s);
 
-			if (result < MIN_BUFFER_SIZE) {
+			if (result < min_buffer_size) {
 				FmtWarning(config_domain, "buffer size {} is too small, using {} bytes instead",
-					   result, MIN_BUFFER_SIZE);
-				result = MIN_BUFFER_SIZE;
+					   result, min_buffer_size);
+				result = min_buffer_size;
 			}
 
 			return result;
 		});
-	}
+	} else
+		/* the default may be too small for a large
+		   "audio_chunk_size" */
+		buffer_size = std::max(buffer_size, min_buffer_size);
 
-	unsigned buffer_chunks = buffer_size / CHUNK_SIZE;
+	unsigned buffer_chunks = buffer_size / chunk_size;
 	if (buffer_chunks >= 1 << 15)
 		throw FmtRuntimeError("buffer size {:?} is too big",
 				      buffer_size);
@@ -44,7 +67,8 @@ GetBufferChunks(const ConfigData &config)
 }
 
 PlayerConfig::PlayerConfig(const ConfigData &config)
-	:buffer_chunks(GetBufferChunks(config)),
+	:chunk_size(GetChunkSize(config)),
+	 buffer_chunks(GetBufferChunks(config, chunk_size)),
 	 audio_format(config.With(ConfigOption::AUDIO_OUTPUT_FORMAT, [](const char *s){
 		 if (s == nullptr)
 			 return AudioFormat::Undefined();
@@ -14,6 +14,14 @@ static constexpr size_t MEGABYTE = 1024 * KILOBYTE;
 struct PlayerConfig {
 	static constexpr size_t DEFAULT_BUFFER_SIZE = 8 * MEGABYTE;
 
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 4 * KILOBYTE;
+
+	/**
+	 * The "audio_chunk_size" setting: the size of each
+	 * #MusicChunk allocation in bytes.
+	 */
+	size_t chunk_size = DEFAULT_CHUNK_SIZE;
+
 	unsigned buffer_chunks = DEFAULT_BUFFER_SIZE;
 
 	/**
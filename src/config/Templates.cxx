@@ -40,6 +40,7 @@ const ConfigTemplate config_param_templates[] = {
 	{ "volume_normalization" },
 	{ "samplerate_converter" },
 	{ "audio_buffer_size" },
+	{ "audio_chunk_size" },
 	{ "buffer_before_play", false, true },
 	{ "http_proxy_host", false, true },
 	{ "http_proxy_port", false, true },
@@ -50,6 +51,7 @@ const ConfigTemplate config_param_templates[] = {
 	{ "max_playlist_length" },
 	{ "max_command_list_size" },
 	{ "max_output_buffer_size" },
+	{ "client_threads" },
 	{ "filesystem_charset" },
 	{ "id3v1_encoding", false, true },
 	{ "metadata_to_use" },
@@ -76,6 +78,8 @@ const ConfigTemplate config_block_templates[] = {
 	{ "resampler" },
 	{ "filter", true },
 	{ "database" },
+	{ "query_cache" },
+	{ "picture_cache" },
 	{ "neighbors", true },
 	{ "partition", true },
 };
@@ -80,11 +80,13 @@ GroupCountVisitor(TagCountMap &map, TagType group,
 void
 PrintSongCount(Response &r, const Partition &partition, const char *name,
 	       const SongFilter *filter,
-	       TagType group)
+	       TagType group,
+	       const std::atomic_bool *cancel)
 {
 	const Database &db = partition.GetDatabaseOrThrow();
 
-	const DatabaseSelection selection(name, true, filter);
+	DatabaseSelection selection(name, true, filter);
+	selection.cancel = cancel;
 
 	if (group == TAG_NUM_OF_ITEM_TYPES) {
 		/* no grouping */
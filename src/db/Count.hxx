@@ -4,6 +4,7 @@
 #ifndef MPD_DB_COUNT_HXX
 #define MPD_DB_COUNT_HXX
 
+#include <atomic>
 #include <cstdint>
 
 enum TagType : uint8_t;
@@ -14,6 +15,7 @@ class SongFilter;
 void
 PrintSongCount(Response &r, const Partition &partition, const char *name,
 	       const SongFilter *filter,
-	       TagType group);
+	       TagType group,
+	       const std::atomic_bool *cancel=nullptr);
 
 #endif
@@ -13,12 +13,16 @@
 #include "LightDirectory.hxx"
 #include "PlaylistInfo.hxx"
 #include "Interface.hxx"
+#include "DatabaseError.hxx"
+#include "Uri.hxx"
+#include "song/Filter.hxx"
 #include "fs/Traits.hxx"
 #include "time/ChronoUtil.hxx"
 #include "util/RecursiveMap.hxx"
 
 #include <fmt/format.h>
 
+#include <cassert>
 #include <functional>
 
 [[gnu::pure]]
@@ -155,6 +159,124 @@ db_selection_print(Response &r, Partition &partition,
 	db.Visit(selection, d, s, p);
 }
 
+/**
+ * Determine the directory where collecting directories for a
+ * #DatabaseSelection shall start: the selection's URI or, if the
+ * filter's URI prefix points to a deeper directory, that one.
+ */
+[[gnu::pure]]
+static std::string_view
+GetStartDirectory(const DatabaseSelection &selection,
+		  std::string_view uri_prefix) noexcept
+{
+	const std::string_view uri = selection.uri;
+
+	const auto slash = uri_prefix.rfind('/');
+	if (slash == uri_prefix.npos)
+		return uri;
+
+	const std::string_view directory = uri_prefix.substr(0, slash);
+	if (directory.size() <= uri.size() ||
+	    !MayContainUriPrefix(uri, directory))
+		return uri;
+
+	return directory;
+}
+
+DatabaseSelectionPrinter::DatabaseSelectionPrinter(const Database &db,
+						   const DatabaseSelection &selection,
+						   bool _full, bool _base)
+	:full(_full), base(_base)
+{
+	assert(CanPrint(selection));
+
+	/* songs outside of the filter's URI prefix cannot match;
+	   skip those directories (like Directory::Walk() does) */
+	const std::string_view uri_prefix = selection.filter != nullptr
+		? selection.filter->GetUriPrefix()
+		: std::string_view{};
+
+	/* collect all directories in the order in which
+	   Directory::Walk() visits them */
+	const std::string start{GetStartDirectory(selection, uri_prefix)};
+	const DatabaseSelection directory_selection(start.c_str(), true);
+
+	try {
+		db.Visit(directory_selection, [this, uri_prefix](const LightDirectory &directory){
+			if (MayContainUriPrefix(directory.GetPath(), uri_prefix))
+				directories.push_back({directory.GetPath(), directory.mtime});
+		}, VisitSong());
+	} catch (const DatabaseError &e) {
+		if (e.GetCode() != DatabaseErrorCode::NOT_FOUND)
+			throw;
+
+		/* this may be a song; leave it to
+		   db_selection_print() */
+		directories.clear();
+	}
+}
+
+bool
+DatabaseSelectionPrinter::CanPrint(const DatabaseSelection &selection) noexcept
+{
+	return selection.recursive &&
+		selection.sort == TAG_NUM_OF_ITEM_TYPES &&
+		selection.window.IsAll();
+}
+
+bool
+DatabaseSelectionPrinter::PrintNext(Response &r, const Database &db,
+				    const SongFilter *filter)
+{
+	if (next >= directories.size())
+		return false;
+
+	const auto &directory = directories[next++];
+	const LightDirectory light{directory.uri.c_str(), directory.mtime};
+
+	/* like db_selection_print(), a filtered selection prints
+	   only songs */
+	if (filter == nullptr) {
+		if (full)
+			PrintDirectoryFull(r, base, light);
+		else
+			PrintDirectoryBrief(r, base, light);
+	}
+
+	if (next > 1 && directories[next - 2].uri == directory.uri)
+		/* the root of a mounted database is reported twice;
+		   its contents have already been printed */
+		return true;
+
+	VisitSong s = [&r,this](const auto &song)
+		{ return full ?
+			PrintSongFull(r, base, song) :
+			PrintSongBrief(r, base, song); };
+
+	const auto p = filter == nullptr
+		? [&r,this](const auto &playlist, const auto &dir)
+			{ return full ?
+				PrintPlaylistFull(r, base, playlist, dir) :
+				PrintPlaylistBrief(r, base, playlist, dir); }
+		: VisitPlaylist();
+
+	/* not passing the filter to the constructor, which would
+	   replace an empty URI with the filter's base */
+	DatabaseSelection directory_selection(directory.uri.c_str(), false);
+	directory_selection.filter = filter;
+
+	try {
+		db.Visit(directory_selection, VisitDirectory(), s, p);
+	} catch (const DatabaseError &e) {
+		if (e.GetCode() != DatabaseErrorCode::NOT_FOUND)
+			throw;
+
+		/* the directory has been deleted meanwhile */
+	}
+
+	return true;
+}
+
 static void
 PrintSongURIVisitor(Response &r, const LightSong &song) noexcept
 {
@@ -163,11 +285,13 @@ PrintSongURIVisitor(Response &r, const LightSong &song) noexcept
 
 void
 PrintSongUris(Response &r, Partition &partition,
-	      const SongFilter *filter)
+	      const SongFilter *filter,
+	      const std::atomic_bool *cancel)
 {
 	const Database &db = partition.GetDatabaseOrThrow();
 
-	const DatabaseSelection selection("", true, filter);
+	DatabaseSelection selection("", true, filter);
+	selection.cancel = cancel;
 
 	const auto f = [&](const auto &song)
 		{ return PrintSongURIVisitor(r, song); };
@@ -202,11 +326,13 @@ void
 PrintUniqueTags(Response &r, Partition &partition,
 		std::span<const TagType> tag_types,
 		const SongFilter *filter,
-		const RangeArg window)
+		const RangeArg window,
+		const std::atomic_bool *cancel)
 {
 	const Database &db = partition.GetDatabaseOrThrow();
 
-	const DatabaseSelection selection("", true, filter);
+	DatabaseSelection selection("", true, filter);
+	selection.cancel = cancel;
 
 	PrintUniqueTags(r, tag_types,
 			db.CollectUniqueTags(selection, tag_types),
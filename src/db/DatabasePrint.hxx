@@ -3,10 +3,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <span>
+#include <string>
+#include <vector>
 
 enum TagType : uint8_t;
+class Database;
 class SongFilter;
 struct DatabaseSelection;
 struct Partition;
@@ -22,12 +28,78 @@ db_selection_print(Response &r, Partition &partition,
 		   const DatabaseSelection &selection,
 		   bool full, bool base);
 
+/**
+ * Prints the result of a recursive #DatabaseSelection incrementally,
+ * one directory at a time, producing the same output as
+ * db_selection_print().  This allows generating huge responses
+ * without buffering all of it.
+ *
+ * The constructor collects the list of directories (which is much
+ * smaller than the response); PrintNext() then visits them one by
+ * one.  Directories which disappear meanwhile are skipped.  For a
+ * filtered selection, directories which cannot contain songs with
+ * the filter's URI prefix are omitted.
+ */
+class DatabaseSelectionPrinter {
+	struct Directory {
+		std::string uri;
+		std::chrono::system_clock::time_point mtime;
+	};
+
+	std::vector<Directory> directories;
+
+	std::size_t next = 0;
+
+	const bool full, base;
+
+public:
+	/**
+	 * Throws on error.
+	 *
+	 * @param full print attributes/tags
+	 * @param base print only base name of songs/directories?
+	 */
+	DatabaseSelectionPrinter(const Database &db,
+				 const DatabaseSelection &selection,
+				 bool _full, bool _base);
+
+	/**
+	 * Can the given #DatabaseSelection be printed incrementally
+	 * by this class?  This is not possible if the result needs
+	 * to be sorted or windowed, or if it does not describe a
+	 * directory.
+	 */
+	[[gnu::pure]]
+	static bool CanPrint(const DatabaseSelection &selection) noexcept;
+
+	/**
+	 * Is there nothing to print?  This happens if the selection
+	 * refers to a song (which shall be printed with
+	 * db_selection_print()).
+	 */
+	bool IsEmpty() const noexcept {
+		return directories.empty();
+	}
+
+	/**
+	 * Print the next directory.  Throws on error.
+	 *
+	 * @param filter the filter of the #DatabaseSelection which
+	 * was passed to the constructor
+	 * @return false if there was nothing left to print
+	 */
+	bool PrintNext(Response &r, const Database &db,
+		       const SongFilter *filter);
+};
+
 void
 PrintSongUris(Response &r, Partition &partition,
-	      const SongFilter *filter);
+	      const SongFilter *filter,
+	      const std::atomic_bool *cancel=nullptr);
 
 void
 PrintUniqueTags(Response &r, Partition &partition,
 		std::span<const TagType> tag_types,
 		const SongFilter *filter,
-		RangeArg window);
+		RangeArg window,
+		const std::atomic_bool *cancel=nullptr);
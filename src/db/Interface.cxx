@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "Interface.hxx"
+#include "DatabaseError.hxx"
+#include "util/ScopeExit.hxx"
+
+void
+Database::GetSongs(std::span<const std::string_view> uris,
+		   VisitSongAt visit) const
+{
+	for (std::size_t i = 0; i < uris.size(); ++i) {
+		const LightSong *song;
+
+		try {
+			song = GetSong(uris[i]);
+		} catch (const DatabaseError &e) {
+			if (e.GetCode() == DatabaseErrorCode::NOT_FOUND)
+				continue;
+
+			throw;
+		}
+
+		if (song == nullptr)
+			continue;
+
+		AtScopeExit(this, song) { ReturnSong(song); };
+
+		visit(i, *song);
+	}
+}
@@ -7,9 +7,12 @@
 #include "Visitor.hxx"
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <span>
 #include <string>
+#include <string_view>
 
 enum TagType : uint8_t;
 struct DatabasePlugin;
@@ -67,6 +70,24 @@ public:
 	 */
 	virtual void ReturnSong(const LightSong *song) const noexcept = 0;
 
+	using VisitSongAt = std::function<void(std::size_t i,
+					       const LightSong &song)>;
+
+	/**
+	 * Look up several songs at once.  The callback is invoked
+	 * with the index (in #uris) of each song which was found;
+	 * songs which do not exist are skipped.  The callback must
+	 * not call back into this object.
+	 *
+	 * The default implementation calls GetSong() for each URI;
+	 * plugins may override it with a more efficient one
+	 * (e.g. one which locks only once).
+	 *
+	 * Throws on error.
+	 */
+	virtual void GetSongs(std::span<const std::string_view> uris,
+			      VisitSongAt visit) const;
+
 	/**
 	 * Visit the selected entities.
 	 *
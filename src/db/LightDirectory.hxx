@@ -22,6 +22,12 @@ struct LightDirectory {
 
 	std::chrono::system_clock::time_point mtime;
 
+	/**
+	 * The name of the album art file in this directory, an empty
+	 * string if there is none, or nullptr if unknown.
+	 */
+	const char *cover = nullptr;
+
 	constexpr LightDirectory(const char *_uri,
 				 std::chrono::system_clock::time_point _mtime)
 		:uri(_uri), mtime(_mtime) {}
@@ -4,6 +4,8 @@
 #include "Selection.hxx"
 #include "song/Filter.hxx"
 
+#include <stdexcept>
+
 DatabaseSelection::DatabaseSelection(const char *_uri, bool _recursive,
 				     const SongFilter *_filter) noexcept
 	:uri(_uri), filter(_filter), recursive(_recursive)
@@ -28,3 +30,10 @@ DatabaseSelection::Match(const LightSong &song) const noexcept
 {
 	return filter == nullptr || filter->Match(song);
 }
+
+void
+DatabaseSelection::CheckCancel() const
+{
+	if (cancel != nullptr && cancel->load(std::memory_order_relaxed))
+		throw std::runtime_error("Query cancelled");
+}
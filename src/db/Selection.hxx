@@ -7,6 +7,7 @@
 #include "protocol/RangeArg.hxx"
 #include "tag/Type.hxx"
 
+#include <atomic>
 #include <string>
 
 class SongFilter;
@@ -40,6 +41,13 @@ struct DatabaseSelection {
 	 */
 	bool recursive;
 
+	/**
+	 * If not nullptr, then this flag may be set by another thread
+	 * to ask the #Database implementation to stop visiting; see
+	 * CheckCancel().
+	 */
+	const std::atomic_bool *cancel = nullptr;
+
 	DatabaseSelection(const char *_uri, bool _recursive,
 			  const SongFilter *_filter=nullptr) noexcept;
 
@@ -48,6 +56,12 @@ struct DatabaseSelection {
 
 	[[gnu::pure]]
 	bool Match(const LightSong &song) const noexcept;
+
+	/**
+	 * Throws if the #cancel flag has been set.  #Database
+	 * implementations call this periodically while visiting.
+	 */
+	void CheckCancel() const;
 };
 
 #endif
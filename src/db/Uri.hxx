@@ -12,4 +12,24 @@ isRootDirectory(std::string_view name) noexcept
 	return name.empty() || (name.size() == 1 && name.front() == '/');
 }
 
+/**
+ * Can the given directory contain songs whose URI begins with the
+ * given prefix (see SongFilter::GetUriPrefix())?
+ */
+[[gnu::pure]]
+static inline bool
+MayContainUriPrefix(std::string_view directory,
+		    std::string_view prefix) noexcept
+{
+	if (directory.empty())
+		/* the root directory contains everything */
+		return true;
+
+	if (prefix.size() <= directory.size())
+		return directory.starts_with(prefix);
+
+	return prefix.starts_with(directory) &&
+		prefix[directory.size()] == '/';
+}
+
 #endif
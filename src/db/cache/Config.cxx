@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "Config.hxx"
+#include "config/Block.hxx"
+#include "config/Parser.hxx"
+
+static constexpr std::size_t KILOBYTE = 1024;
+static constexpr std::size_t MEGABYTE = 1024 * KILOBYTE;
+
+static std::size_t
+GetSizeParam(const ConfigBlock &block, std::size_t default_value)
+{
+	const auto *size_param = block.GetBlockParam("size");
+	if (size_param == nullptr)
+		return default_value;
+
+	return size_param->With([](const char *s){
+		return ParseSize(s);
+	});
+}
+
+QueryCacheConfig::QueryCacheConfig(const ConfigBlock &block)
+	:size(GetSizeParam(block, 16 * MEGABYTE))
+{
+}
+
+PictureCacheConfig::PictureCacheConfig(const ConfigBlock &block)
+	:size(GetSizeParam(block, 16 * MEGABYTE))
+{
+}
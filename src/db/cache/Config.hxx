@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include <cstddef>
+
+struct ConfigBlock;
+
+struct QueryCacheConfig {
+	/**
+	 * The memory budget of the whole cache (in bytes).
+	 */
+	std::size_t size;
+
+	explicit QueryCacheConfig(const ConfigBlock &block);
+};
+
+struct PictureCacheConfig {
+	/**
+	 * The memory budget of the whole cache (in bytes).
+	 */
+	std::size_t size;
+
+	explicit PictureCacheConfig(const ConfigBlock &block);
+};
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "PictureCache.hxx"
+#include "Config.hxx"
+
+#include <algorithm> // for std::copy()
+
+/**
+ * The approximate number of bytes occupied by an item.
+ */
+static std::size_t
+GetItemSize(const std::string &key, const CachedPicture &picture) noexcept
+{
+	return sizeof(key) + sizeof(PictureCache::TimePoint) +
+		sizeof(picture) + key.size() +
+		picture.mime_type.size() + picture.data.size();
+}
+
+PictureCache::PictureCache(const PictureCacheConfig &config) noexcept
+	:cache(config.size)
+{
+}
+
+PictureCache::~PictureCache() noexcept = default;
+
+const CachedPicture *
+PictureCache::Get(std::string_view key, TimePoint mtime) noexcept
+{
+	const auto *item = cache.Get(key);
+	if (item == nullptr) {
+		++misses;
+		return nullptr;
+	}
+
+	if (item->mtime != mtime) {
+		/* the file has been modified */
+		cache.Remove(key);
+		++misses;
+		return nullptr;
+	}
+
+	++hits;
+	return &item->picture;
+}
+
+const CachedPicture *
+PictureCache::Put(std::string &&key, TimePoint mtime,
+		  CachedPicture &&picture) noexcept
+{
+	const std::size_t size = GetItemSize(key, picture);
+	if (size > GetMaxItemSize())
+		return nullptr;
+
+	auto *item = cache.Put(std::move(key), {mtime, std::move(picture)},
+			       size);
+	return item != nullptr ? &item->picture : nullptr;
+}
+
+void
+PictureCache::Invalidate() noexcept
+{
+	cache.Clear();
+	++generation;
+}
+
+void
+PictureCacheFiller::Start(const PictureCache &cache, std::string_view _key,
+			  PictureCache::TimePoint _mtime, std::size_t size)
+{
+	Reset();
+
+	key = _key;
+	mtime = _mtime;
+	picture.data.ResizeDiscard(size);
+	position = 0;
+	generation = cache.GetGeneration();
+	active = true;
+}
+
+const CachedPicture *
+PictureCacheFiller::Add(PictureCache &cache, std::string_view _key,
+			std::size_t offset,
+			std::span<const std::byte> src) noexcept
+{
+	if (!active)
+		return nullptr;
+
+	if (_key != key || offset != position ||
+	    src.size() > picture.data.size() - position ||
+	    generation != cache.GetGeneration()) {
+		Reset();
+		return nullptr;
+	}
+
+	std::copy(src.begin(), src.end(), picture.data.begin() + position);
+	position += src.size();
+
+	if (position < picture.data.size())
+		return nullptr;
+
+	const auto *result = cache.Put(std::move(key), mtime,
+				       std::move(picture));
+	Reset();
+	return result;
+}
+
+void
+PictureCacheFiller::Reset() noexcept
+{
+	active = false;
+	key.clear();
+	picture = {};
+}
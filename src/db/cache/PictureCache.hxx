@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "util/AllocatedArray.hxx"
+#include "util/LRUCache.hxx"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // for std::equal_to
+#include <span>
+#include <string>
+#include <string_view>
+
+struct PictureCacheConfig;
+
+/**
+ * A picture (e.g. cover art) which was loaded completely into
+ * memory by #PictureCache.
+ */
+struct CachedPicture {
+	/**
+	 * The MIME type; empty if unknown.
+	 */
+	std::string mime_type;
+
+	AllocatedArray<std::byte> data;
+
+	std::span<const std::byte> GetData() const noexcept {
+		return {data.data(), data.size()};
+	}
+};
+
+/**
+ * A cache for pictures served by "albumart" and "readpicture", so
+ * that requesting a picture chunk by chunk does not reopen and
+ * rescan the file for each chunk.  Each item is keyed by a string
+ * (built by the caller from the command name and the URI) and a
+ * modification time; an item whose modification time differs is
+ * considered stale.
+ *
+ * All entries are discarded by Invalidate(), which must be called
+ * whenever the database gets modified.
+ *
+ * This class is not thread-safe; it may only be used from the main
+ * thread.
+ */
+class PictureCache {
+public:
+	using TimePoint = std::chrono::system_clock::time_point;
+
+private:
+	struct Item {
+		TimePoint mtime;
+		CachedPicture picture;
+	};
+
+	LRUCache<std::string, Item,
+		 std::hash<std::string_view>,
+		 std::equal_to<std::string_view>> cache;
+
+	uint_least64_t hits = 0, misses = 0;
+
+	/**
+	 * Incremented by Invalidate(); allows #PictureCacheFiller to
+	 * detect that the database was modified while it was
+	 * collecting a picture.
+	 */
+	unsigned generation = 0;
+
+public:
+	explicit PictureCache(const PictureCacheConfig &config) noexcept;
+	~PictureCache() noexcept;
+
+	PictureCache(const PictureCache &) = delete;
+	PictureCache &operator=(const PictureCache &) = delete;
+
+	/**
+	 * The largest picture which will be accepted by Put().
+	 */
+	std::size_t GetMaxItemSize() const noexcept {
+		return cache.GetMaxSize() / 4;
+	}
+
+	uint_least64_t GetHits() const noexcept {
+		return hits;
+	}
+
+	uint_least64_t GetMisses() const noexcept {
+		return misses;
+	}
+
+	unsigned GetGeneration() const noexcept {
+		return generation;
+	}
+
+	/**
+	 * Look up a picture and update the hit/miss counters.  A
+	 * stale item (with a different modification time) is
+	 * deleted.
+	 *
+	 * @return the picture or nullptr if there is no such entry;
+	 * the pointer is valid until the next call to a non-const
+	 * method
+	 */
+	const CachedPicture *Get(std::string_view key, TimePoint mtime) noexcept;
+
+	/**
+	 * Store a picture.  It is discarded if it is too large.
+	 *
+	 * @return the new item or nullptr if it was discarded; the
+	 * pointer is valid until the next call to a non-const method
+	 */
+	const CachedPicture *Put(std::string &&key, TimePoint mtime,
+		 CachedPicture &&picture) noexcept;
+
+	/**
+	 * Discard all entries.  To be called after the database has
+	 * been modified.
+	 */
+	void Invalidate() noexcept;
+};
+
+/**
+ * Collects a picture from chunks which are read one after another
+ * (e.g. while a client requests a file with "albumart" chunk by
+ * chunk) and adds it to the #PictureCache once it is complete.  This
+ * fills the cache without having to read the whole file at once.
+ */
+class PictureCacheFiller {
+	std::string key;
+
+	PictureCache::TimePoint mtime;
+
+	CachedPicture picture;
+
+	/**
+	 * The number of bytes of #picture which have been filled
+	 * already.
+	 */
+	std::size_t position;
+
+	/**
+	 * The PictureCache::GetGeneration() value at the time
+	 * Start() was called.
+	 */
+	unsigned generation;
+
+	bool active = false;
+
+public:
+	/**
+	 * Start collecting a new picture, discarding the previous
+	 * one.
+	 *
+	 * Throws std::bad_alloc on error.
+	 */
+	void Start(const PictureCache &cache, std::string_view _key,
+		   PictureCache::TimePoint _mtime, std::size_t size);
+
+	/**
+	 * Add a chunk of the picture.  If it does not belong to the
+	 * picture being collected or is not adjacent to the previous
+	 * chunk, then the picture is discarded.
+	 *
+	 * @return the new cache item if the picture is complete now,
+	 * nullptr otherwise
+	 */
+	const CachedPicture *Add(PictureCache &cache, std::string_view _key,
+				 std::size_t offset,
+				 std::span<const std::byte> src) noexcept;
+
+	/**
+	 * Discard the picture being collected.
+	 */
+	void Reset() noexcept;
+};
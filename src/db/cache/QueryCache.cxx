@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "QueryCache.hxx"
+#include "Config.hxx"
+
+/**
+ * The approximate number of bytes occupied by an item.
+ */
+static constexpr std::size_t
+GetItemSize(const std::string &key, const std::string &value) noexcept
+{
+	return sizeof(key) + sizeof(value) + key.size() + value.size();
+}
+
+QueryCache::QueryCache(const QueryCacheConfig &config) noexcept
+	:cache(config.size)
+{
+}
+
+QueryCache::~QueryCache() noexcept = default;
+
+const std::string *
+QueryCache::Get(std::string_view key) noexcept
+{
+	const auto *value = cache.Get(key);
+	if (value == nullptr)
+		++misses;
+	else
+		++hits;
+	return value;
+}
+
+void
+QueryCache::Put(std::string &&key, std::string &&value,
+		uint_least64_t _serial) noexcept
+{
+	if (_serial != serial)
+		/* the database has been modified meanwhile; the
+		   response may be stale */
+		return;
+
+	const std::size_t size = GetItemSize(key, value);
+	if (size > GetMaxItemSize())
+		return;
+
+	cache.Put(std::move(key), std::move(value), size);
+}
+
+void
+QueryCache::Invalidate() noexcept
+{
+	++serial;
+	cache.Clear();
+}
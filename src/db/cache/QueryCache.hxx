@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "util/LRUCache.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional> // for std::equal_to
+#include <string>
+#include <string_view>
+
+struct QueryCacheConfig;
+
+/**
+ * A cache for the serialized responses of database queries
+ * ("find", "search").  The caller is responsible for building a
+ * key which describes everything the response depends on.
+ *
+ * All entries are discarded by Invalidate(), which must be called
+ * whenever the database gets modified.  Each invalidation
+ * increments a serial number; a response which was generated
+ * before an invalidation will not be stored.
+ *
+ * This class is not thread-safe; it may only be used from the main
+ * thread.
+ */
+class QueryCache {
+	/**
+	 * Maps the key to the response.
+	 */
+	LRUCache<std::string, std::string,
+		 std::hash<std::string_view>,
+		 std::equal_to<std::string_view>> cache;
+
+	/**
+	 * Incremented by Invalidate().
+	 */
+	uint_least64_t serial = 0;
+
+	uint_least64_t hits = 0, misses = 0;
+
+public:
+	explicit QueryCache(const QueryCacheConfig &config) noexcept;
+	~QueryCache() noexcept;
+
+	QueryCache(const QueryCache &) = delete;
+	QueryCache &operator=(const QueryCache &) = delete;
+
+	/**
+	 * The largest response which will be accepted by Put().
+	 */
+	std::size_t GetMaxItemSize() const noexcept {
+		return cache.GetMaxSize() / 8;
+	}
+
+	uint_least64_t GetSerial() const noexcept {
+		return serial;
+	}
+
+	uint_least64_t GetHits() const noexcept {
+		return hits;
+	}
+
+	uint_least64_t GetMisses() const noexcept {
+		return misses;
+	}
+
+	/**
+	 * Look up a cached response and update the hit/miss
+	 * counters.
+	 *
+	 * @return the response or nullptr if there is no such entry;
+	 * the pointer is valid until the next call to a non-const
+	 * method
+	 */
+	const std::string *Get(std::string_view key) noexcept;
+
+	/**
+	 * Store a response.  It is discarded if it is too large or if
+	 * the cache has been invalidated after the given serial was
+	 * obtained with GetSerial().
+	 */
+	void Put(std::string &&key, std::string &&value,
+		 uint_least64_t _serial) noexcept;
+
+	/**
+	 * Discard all entries.  To be called after the database has
+	 * been modified.
+	 */
+	void Invalidate() noexcept;
+};
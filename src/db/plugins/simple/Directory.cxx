@@ -225,20 +225,28 @@ Directory::Sort() noexcept
 }
 
 void
-Directory::Walk(bool recursive, const SongFilter *filter,
+Directory::Walk(const DatabaseSelection &selection,
 		bool hide_playlist_targets,
 		const VisitDirectory& visit_directory, const VisitSong& visit_song,
 		const VisitPlaylist& visit_playlist) const
 {
+	selection.CheckCancel();
+
+	const SongFilter *const filter = selection.filter;
+
 	if (IsMount()) {
 		assert(IsEmpty());
 
 		/* TODO: eliminate this unlock/lock; it is necessary
 		   because the child's SimpleDatabasePlugin::Visit()
 		   call will lock it again */
+		DatabaseSelection mount_selection("", selection.recursive,
+						  filter);
+		mount_selection.cancel = selection.cancel;
+
 		const ScopeDatabaseUnlock unlock;
 		WalkMount(GetPath(), *mounted_database,
-			  "", DatabaseSelection("", recursive, filter),
+			  "", mount_selection,
 			  visit_directory, visit_song,
 			  visit_playlist);
 		return;
@@ -260,12 +268,22 @@ Directory::Walk(bool recursive, const SongFilter *filter,
 			visit_playlist(p, Export());
 	}
 
+	/* optimization: if only songs are visited and the filter
+	   restricts the URI prefix, skip subtrees which cannot
+	   contain matching songs */
+	const std::string_view uri_prefix =
+		filter != nullptr && !visit_directory && !visit_playlist
+		? filter->GetUriPrefix()
+		: std::string_view{};
+
 	for (auto &child : children) {
 		if (visit_directory)
 			visit_directory(child.Export());
 
-		if (recursive)
-			child.Walk(recursive, filter,
+		if (selection.recursive &&
+		    (uri_prefix.empty() ||
+		     MayContainUriPrefix(child.GetPath(), uri_prefix)))
+			child.Walk(selection,
 				   hide_playlist_targets,
 				   visit_directory, visit_song,
 				   visit_playlist);
@@ -275,5 +293,8 @@ Directory::Walk(bool recursive, const SongFilter *filter,
 LightDirectory
 Directory::Export() const noexcept
 {
-	return {GetPath(), mtime};
+	LightDirectory result{GetPath(), mtime};
+	if (cover)
+		result.cover = cover->c_str();
+	return result;
 }
@@ -11,6 +11,7 @@
 #include "db/Ptr.hxx"
 #include "util/IntrusiveList.hxx"
 
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -33,7 +34,7 @@ static constexpr unsigned DEVICE_CONTAINER = -2;
  */
 static constexpr unsigned DEVICE_PLAYLIST = -3;
 
-class SongFilter;
+struct DatabaseSelection;
 
 struct Directory : IntrusiveListHook<> {
 	/* Note: the #IntrusiveListHook is protected with the global
@@ -69,6 +70,18 @@ struct Directory : IntrusiveListHook<> {
 
 	const std::string path;
 
+	/**
+	 * The actual name of the album art file in this directory
+	 * (one of #cover_art_names, ignoring case), an empty string
+	 * if there is none, or
+	 * std::nullopt if this is unknown (the directory was not
+	 * scanned yet).
+	 *
+	 * This attribute is protected with the global #db_mutex.
+	 * Read access in the update thread does not need protection.
+	 */
+	std::optional<std::string> cover;
+
 	/**
 	 * If this is not nullptr, then this directory does not really
 	 * exist, but is a mount point for another #Database.
@@ -284,9 +297,13 @@ public:
 	void Sort() noexcept;
 
 	/**
+	 * Visit this directory and (if #DatabaseSelection::recursive
+	 * is set) all of its children.  The selection's URI, sort
+	 * and window are ignored.
+	 *
 	 * Caller must lock #db_mutex.
 	 */
-	void Walk(bool recursive, const SongFilter *match,
+	void Walk(const DatabaseSelection &selection,
 		  bool hide_playlist_targets,
 		  const VisitDirectory& visit_directory, const VisitSong& visit_song,
 		  const VisitPlaylist& visit_playlist) const;
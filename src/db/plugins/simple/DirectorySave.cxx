@@ -27,6 +27,7 @@
 #define DIRECTORY_MTIME "mtime: "
 #define DIRECTORY_BEGIN "begin: "
 #define DIRECTORY_END "end: "
+#define DIRECTORY_COVER "cover: "
 
 [[gnu::const]]
 static const char *
@@ -76,6 +77,9 @@ directory_save(BufferedOutputStream &os, const Directory &directory)
 		os.Fmt(DIRECTORY_BEGIN "{}\n", directory.GetPath());
 	}
 
+	if (directory.cover)
+		os.Fmt(DIRECTORY_COVER "{}\n", *directory.cover);
+
 	for (const auto &child : directory.children) {
 		if (child.IsMount())
 			continue;
@@ -148,7 +152,9 @@ directory_load(LineReader &file, Directory &directory)
 	while ((line = file.ReadLine()) != nullptr &&
 	       !StringStartsWith(line, DIRECTORY_END)) {
 		const char *p;
-		if ((p = StringAfterPrefix(line, DIRECTORY_DIR))) {
+		if ((p = StringAfterPrefix(line, DIRECTORY_COVER))) {
+			directory.cover = p;
+		} else if ((p = StringAfterPrefix(line, DIRECTORY_DIR))) {
 			auto *child = directory_load_subdir(file, directory, p);
 
 			const std::string_view name = child->GetName();
@@ -36,6 +36,7 @@
 
 #include <cerrno>
 #include <memory>
+#include <vector>
 
 static constexpr Domain simple_db_domain("simple_db");
 
@@ -251,6 +252,45 @@ SimpleDatabase::ReturnSong([[maybe_unused]] const LightSong *song) const noexcep
 	}
 }
 
+void
+SimpleDatabase::GetSongs(std::span<const std::string_view> uris,
+			 VisitSongAt visit) const
+{
+	assert(root != nullptr);
+
+	/* songs inside mounted databases are looked up after the
+	   lock has been released */
+	std::vector<std::size_t> mounted;
+
+	{
+		const ScopeDatabaseLock protect;
+
+		for (std::size_t i = 0; i < uris.size(); ++i) {
+			auto r = root->LookupDirectory(uris[i]);
+			if (r.directory->IsMount()) {
+				mounted.push_back(i);
+				continue;
+			}
+
+			if (r.rest.empty() ||
+			    r.rest.find('/') != std::string_view::npos)
+				/* not a song */
+				continue;
+
+			const Song *song = r.directory->FindSong(r.rest);
+			if (song != nullptr)
+				visit(i, song->Export());
+		}
+	}
+
+	for (const std::size_t i : mounted) {
+		std::string_view uri = uris[i];
+		Database::GetSongs({&uri, 1}, [i, &visit](std::size_t, const LightSong &song){
+			visit(i, song);
+		});
+	}
+}
+
 [[gnu::const]]
 static DatabaseSelection
 CheckSelection(DatabaseSelection selection) noexcept
@@ -290,8 +330,7 @@ SimpleDatabase::Visit(const DatabaseSelection &selection,
 		if (selection.recursive && visit_directory)
 			visit_directory(r.directory->Export());
 
-		r.directory->Walk(selection.recursive, selection.filter,
-				  hide_playlist_targets,
+		r.directory->Walk(selection, hide_playlist_targets,
 				  visit_directory, visit_song,
 				  visit_playlist);
 		helper.Commit();
@@ -467,6 +506,6 @@ SimpleDatabase::Unmount(const char *uri) noexcept
 
 constexpr DatabasePlugin simple_db_plugin = {
 	"simple",
-	DatabasePlugin::FLAG_REQUIRE_STORAGE,
+	DatabasePlugin::FLAG_REQUIRE_STORAGE|DatabasePlugin::FLAG_THREAD_SAFE,
 	SimpleDatabase::Create,
 };
@@ -109,6 +109,9 @@ public:
 	const LightSong *GetSong(std::string_view uri_utf8) const override;
 	void ReturnSong(const LightSong *song) const noexcept override;
 
+	void GetSongs(std::span<const std::string_view> uris,
+		      VisitSongAt visit) const override;
+
 	void Visit(const DatabaseSelection &selection,
 		   VisitDirectory visit_directory,
 		   VisitSong visit_song,
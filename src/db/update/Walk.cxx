@@ -11,6 +11,7 @@
 #include "db/plugins/simple/Song.hxx"
 #include "storage/StorageInterface.hxx"
 #include "ExcludeList.hxx"
+#include "CoverArt.hxx"
 #include "fs/AllocatedPath.hxx"
 #include "fs/Traits.hxx"
 #include "fs/FileSystem.hxx"
@@ -23,6 +24,7 @@
 #include "util/UriExtract.hxx"
 #include "Log.hxx"
 
+#include <algorithm> // for std::min()
 #include <cassert>
 #include <cerrno>
 #include <exception>
@@ -357,6 +359,11 @@ UpdateWalk::UpdateDirectory(Directory &directory,
 
 	UnmarkAllIn(directory);
 
+	/* the index of the preferred album art file found so far
+	   (see #cover_art_names) and its actual name */
+	std::size_t cover = cover_art_names.size();
+	std::string cover_name;
+
 	const char *name_utf8;
 	while (!cancel && (name_utf8 = reader->Read()) != nullptr) {
 		if (skip_path(name_utf8))
@@ -379,9 +386,22 @@ UpdateWalk::UpdateDirectory(Directory &directory,
 			continue;
 		}
 
+		if (info2.IsRegular()) {
+			if (const std::size_t i = FindCoverArtName(name_utf8);
+			    i < cover) {
+				cover = i;
+				cover_name = name_utf8;
+			}
+		}
+
 		UpdateDirectoryChild(directory, child_exclude_list, name_utf8, info2);
 	}
 
+	if (!cancel) {
+		const ScopeDatabaseLock protect;
+		directory.cover = std::move(cover_name);
+	}
+
 	PurgeDeletedFromDirectory(directory);
 
 	directory.mtime = info.mtime;
@@ -487,6 +507,14 @@ try {
 
 	const char *name = PathTraitsUTF8::GetBase(uri);
 
+	if (FindCoverArtName(name) < cover_art_names.size()) {
+		/* the album art file may have been added or removed;
+		   we don't know which one is preferred until the
+		   whole directory gets scanned again */
+		const ScopeDatabaseLock protect;
+		parent->cover.reset();
+	}
+
 	if (SkipSymlink(parent, name)) {
 		modified |= editor.DeleteNameIn(*parent, name);
 		return;
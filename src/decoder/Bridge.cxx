@@ -441,18 +441,11 @@ DecoderBridge::SubmitTimestamp(FloatDuration t) noexcept
 }
 
 DecoderCommand
-DecoderBridge::SubmitAudio(InputStream *is,
-			   std::span<const std::byte> audio,
-			   uint16_t kbit_rate) noexcept
+DecoderBridge::PrepareAudio(InputStream *is) noexcept
 {
-	assert(dc.state == DecoderState::DECODE);
-	assert(dc.pipe != nullptr);
-	assert(audio.size() % dc.in_audio_format.GetFrameSize() == 0);
-
 	DecoderCommand cmd = LockGetVirtualCommand();
 
-	if (cmd == DecoderCommand::STOP || cmd == DecoderCommand::SEEK ||
-	    audio.empty())
+	if (cmd == DecoderCommand::STOP || cmd == DecoderCommand::SEEK)
 		return cmd;
 
 	assert(!initial_seek_pending);
@@ -473,27 +466,66 @@ DecoderBridge::SubmitAudio(InputStream *is,
 			return cmd;
 	}
 
-	cmd = DecoderCommand::NONE;
+	return DecoderCommand::NONE;
+}
+
+bool
+DecoderBridge::ApplyEndTime(std::size_t &n_frames) const noexcept
+{
+	if (!dc.end_time.IsPositive())
+		return false;
+
+	const auto end_frame =
+		dc.end_time.ToScale<uint64_t>(dc.in_audio_format.sample_rate);
+	if (absolute_frame >= end_frame) {
+		n_frames = 0;
+		return true;
+	}
+
+	const uint64_t remaining_frames = end_frame - absolute_frame;
+	if (n_frames >= remaining_frames) {
+		/* past the end of the range: truncate this data
+		   submission and stop the decoder */
+		n_frames = remaining_frames;
+		return true;
+	}
+
+	return false;
+}
+
+DecoderCommand
+DecoderBridge::SubmitAudio(InputStream *is,
+			   std::span<const std::byte> audio,
+			   uint16_t kbit_rate) noexcept
+{
+	assert(dc.state == DecoderState::DECODE);
+	assert(dc.pipe != nullptr);
+	assert(audio.size() % dc.in_audio_format.GetFrameSize() == 0);
+
+	if (audio.empty())
+		return LockGetVirtualCommand();
+
+	if (auto cmd = PrepareAudio(is); cmd != DecoderCommand::NONE)
+		return cmd;
+
+	return AppendAudio(audio, kbit_rate);
+}
+
+DecoderCommand
+DecoderBridge::AppendAudio(std::span<const std::byte> audio,
+			   uint16_t kbit_rate) noexcept
+{
+	DecoderCommand cmd = DecoderCommand::NONE;
 
 	const size_t frame_size = dc.in_audio_format.GetFrameSize();
 	size_t data_frames = audio.size() / frame_size;
 
-	if (dc.end_time.IsPositive()) {
-		/* enforce the given end time */
+	if (ApplyEndTime(data_frames)) {
+		audio = audio.first(data_frames * frame_size);
+		cmd = DecoderCommand::STOP;
 
-		const auto end_frame =
-			dc.end_time.ToScale<uint64_t>(dc.in_audio_format.sample_rate);
-		if (absolute_frame >= end_frame)
-			return DecoderCommand::STOP;
-
-		const uint64_t remaining_frames = end_frame - absolute_frame;
-		if (data_frames >= remaining_frames) {
-			/* past the end of the range: truncate this
-			   data submission and stop the decoder */
-			data_frames = remaining_frames;
-			audio = audio.first(data_frames * frame_size);
-			cmd = DecoderCommand::STOP;
-		}
+		if (audio.empty())
+			return cmd;
 	}
 
 	if (convert != nullptr) {
@@ -556,6 +588,89 @@ DecoderBridge::SubmitAudio(InputStream *is,
 	return cmd;
 }
 
+std::span<std::byte>
+DecoderBridge::GetAudioBuffer(InputStream *is, uint16_t kbit_rate) noexcept
+{
+	assert(dc.state == DecoderState::DECODE);
+	assert(dc.pipe != nullptr);
+
+	audio_buffer = {};
+
+	if (PrepareAudio(is) != DecoderCommand::NONE)
+		return {};
+
+	audio_buffer_kbit_rate = kbit_rate;
+
+	if (convert != nullptr) {
+		/* the data needs to be converted before it can be
+		   copied to a MusicChunk; let the decoder plugin
+		   write it to a temporary buffer */
+		const size_t frame_size = dc.in_audio_format.GetFrameSize();
+		const size_t size = dc.buffer->GetChunkDataSize()
+			/ frame_size * frame_size;
+		audio_buffer = {convert_buffer.GetT<std::byte>(size), size};
+		return audio_buffer;
+	}
+
+	while (true) {
+		auto *chunk = GetChunk();
+		if (chunk == nullptr)
+			return {};
+
+		audio_buffer = chunk->Write(dc.out_audio_format,
+					    SongTime::Cast(timestamp) -
+					    dc.song->GetStartTime(),
+					    kbit_rate);
+		if (!audio_buffer.empty())
+			return audio_buffer;
+
+		/* the chunk is full, flush it */
+		FlushChunk();
+	}
+}
+
+DecoderCommand
+DecoderBridge::CommitAudio(std::size_t nbytes) noexcept
+{
+	assert(dc.state == DecoderState::DECODE);
+	assert(nbytes <= audio_buffer.size());
+	assert(nbytes % dc.in_audio_format.GetFrameSize() == 0);
+
+	const auto buffer = audio_buffer.first(nbytes);
+	audio_buffer = {};
+
+	if (buffer.empty())
+		return LockGetVirtualCommand();
+
+	if (convert != nullptr)
+		return AppendAudio(buffer, audio_buffer_kbit_rate);
+
+	/* the decoder plugin has written directly to the current
+	   chunk */
+
+	assert(current_chunk != nullptr);
+	assert(buffer.data() == current_chunk->ReadData().data() +
+	       current_chunk->length);
+
+	const size_t frame_size = dc.out_audio_format.GetFrameSize();
+	size_t n_frames = nbytes / frame_size;
+	const auto cmd = ApplyEndTime(n_frames)
+		? DecoderCommand::STOP
+		: DecoderCommand::NONE;
+	nbytes = n_frames * frame_size;
+	if (nbytes == 0)
+		return cmd;
+
+	if (current_chunk->Expand(dc.out_audio_format, nbytes))
+		/* the chunk is full, flush it */
+		FlushChunk();
+
+	timestamp += dc.out_audio_format.SizeToTime<FloatDuration>(nbytes);
+	absolute_frame += n_frames;
+
+	return cmd;
+}
+
 DecoderCommand
 DecoderBridge::SubmitTag(InputStream *is, Tag &&tag) noexcept
 {
@@ -6,6 +6,7 @@
 #include "Client.hxx"
 #include "tag/ReplayGainInfo.hxx"
 #include "MusicChunkPtr.hxx"
+#include "pcm/Buffer.hxx"
 
 #include <cstddef>
 #include <exception>
@@ -33,6 +34,25 @@ private:
 	 */
 	std::unique_ptr<PcmConvert> convert;
 
+	/**
+	 * The buffer returned by GetAudioBuffer() if the data needs
+	 * to be converted (i.e. cannot be written to a #MusicChunk
+	 * directly).
+	 */
+	PcmBuffer convert_buffer;
+
+	/**
+	 * The buffer returned by the last GetAudioBuffer() call; it
+	 * points either into #current_chunk or into
+	 * #convert_buffer.
+	 */
+	std::span<std::byte> audio_buffer;
+
+	/**
+	 * The kbit_rate parameter of the last GetAudioBuffer() call.
+	 */
+	uint16_t audio_buffer_kbit_rate = 0;
+
 	/**
 	 * The time stamp of the next data chunk, in seconds.
 	 */
@@ -165,6 +185,9 @@ public:
 	DecoderCommand SubmitAudio(InputStream *is,
 				   std::span<const std::byte> audio,
 				   uint16_t kbit_rate) noexcept override;
+	std::span<std::byte> GetAudioBuffer(InputStream *is,
+					    uint16_t kbit_rate) noexcept override;
+	DecoderCommand CommitAudio(std::size_t nbytes) noexcept override;
 	DecoderCommand SubmitTag(InputStream *is, Tag &&tag) noexcept override;
 	void SubmitReplayGain(const ReplayGainInfo *replay_gain_info) noexcept override;
 	void SubmitMixRamp(MixRampInfo &&mix_ramp) noexcept override;
@@ -191,4 +214,27 @@ private:
 	DecoderCommand DoSendTag(const Tag &tag) noexcept;
 
 	bool UpdateStreamTag(InputStream *is) noexcept;
+
+	/**
+	 * Common code for SubmitAudio() and GetAudioBuffer(): check
+	 * for a pending command and send the stream tag.
+	 *
+	 * @return DecoderCommand::NONE if audio data may be submitted
+	 */
+	DecoderCommand PrepareAudio(InputStream *is) noexcept;
+
+	/**
+	 * Enforce DecoderControl::end_time by truncating the number
+	 * of frames which are going to be submitted.
+	 *
+	 * @return true if the end time has been reached, i.e. the
+	 * decoder shall stop after submitting the (truncated) data
+	 */
+	bool ApplyEndTime(std::size_t &n_frames) const noexcept;
+
+	/**
+	 * Convert the given data and copy it to the #MusicPipe.
+	 */
+	DecoderCommand AppendAudio(std::span<const std::byte> audio,
+				   uint16_t kbit_rate) noexcept;
 };
@@ -145,6 +145,43 @@ public:
 		return SubmitAudio(is, audio_bytes, kbit_rate);
 	}
 
+	/**
+	 * Obtain a buffer which the decoder plugin may fill with PCM
+	 * data (in the format passed to Ready()) and then submit with
+	 * CommitAudio().  If no conversion is necessary, this buffer
+	 * points directly into the #MusicPipe, which saves the copy
+	 * done by SubmitAudio().
+	 *
+	 * Until CommitAudio() is called, no other method except
+	 * Read() may be called.  Not calling CommitAudio() at all
+	 * discards the buffer.
+	 *
+	 * @param is an input stream which is buffering while we are waiting
+	 * for the player
+	 * @param kbit_rate the current bit rate of the source file
+	 * @return a buffer whose size is a multiple of the frame
+	 * size, or an empty span if a command is pending (call
+	 * GetCommand() to obtain it)
+	 */
+	virtual std::span<std::byte> GetAudioBuffer(InputStream *is,
+						    uint16_t kbit_rate) noexcept = 0;
+
+	std::span<std::byte> GetAudioBuffer(InputStream &is,
+					    uint16_t kbit_rate) noexcept {
+		return GetAudioBuffer(&is, kbit_rate);
+	}
+
+	/**
+	 * Submit data which was written to the buffer returned by
+	 * GetAudioBuffer().
+	 *
+	 * @param nbytes the number of bytes which were written; must
+	 * be a multiple of the frame size
+	 * @return the current command, or DecoderCommand::NONE if there is no
+	 * command pending
+	 */
+	virtual DecoderCommand CommitAudio(std::size_t nbytes) noexcept = 0;
+
 	/**
 	 * This function is called by the decoder plugin when it has
 	 * successfully decoded a tag.
@@ -9,8 +9,6 @@
 #include "lib/ffmpeg/Domain.hxx"
 #include "lib/ffmpeg/Error.hxx"
 #include "lib/ffmpeg/Init.hxx"
-#include "lib/ffmpeg/Interleave.hxx"
-#include "lib/ffmpeg/Buffer.hxx"
 #include "lib/ffmpeg/Frame.hxx"
 #include "lib/ffmpeg/Format.hxx"
 #include "lib/ffmpeg/Codec.hxx"
@@ -19,6 +17,7 @@
 #include "../DecoderAPI.hxx"
 #include "FfmpegMetaData.hxx"
 #include "FfmpegIo.hxx"
+#include "pcm/ChannelDefs.hxx"
 #include "pcm/Interleave.hxx"
 #include "tag/Builder.hxx"
 #include "tag/Handler.hxx"
@@ -40,6 +39,8 @@ extern "C" {
 #include <libavutil/frame.h>
 }
 
+#include <algorithm> // for std::min()
+#include <array>
 #include <cassert>
 
 #include <string.h>
@@ -195,29 +196,79 @@ PtsToPcmFrame(uint64_t pts, const AVStream &stream,
 
 /**
  * Invoke DecoderClient::SubmitAudio() with the contents of an
- * #AVFrame.
+ * #AVFrame.  Planar data is interleaved directly into the buffers
+ * obtained from DecoderClient::GetAudioBuffer().
  */
 static DecoderCommand
 FfmpegSendFrame(DecoderClient &client, InputStream *is,
 		AVCodecContext &codec_context,
 		const AVFrame &frame,
-		size_t &skip_bytes,
-		FfmpegBuffer &buffer)
+		size_t &skip_bytes)
 {
-	auto output_buffer = Ffmpeg::InterleaveFrame(frame, buffer);
+	assert(frame.nb_samples > 0);
+
+	const auto format = AVSampleFormat(frame.format);
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 25, 100)
+	const unsigned channels = frame.ch_layout.nb_channels;
+#else
+	const unsigned channels = frame.channels;
+#endif
+	assert(channels <= MAX_CHANNELS);
+
+	const std::size_t sample_size = av_get_bytes_per_sample(format);
+	const std::size_t frame_size = channels * sample_size;
+	std::size_t n_frames = frame.nb_samples;
+	std::size_t offset = 0;
 
 	if (skip_bytes > 0) {
-		if (skip_bytes >= output_buffer.size()) {
-			skip_bytes -= output_buffer.size();
+		const std::size_t size = n_frames * frame_size;
+		if (skip_bytes >= size) {
+			skip_bytes -= size;
 			return DecoderCommand::NONE;
 		}
 
-		output_buffer = output_buffer.subspan(skip_bytes);
+		offset = skip_bytes / frame_size;
+		n_frames -= offset;
 		skip_bytes = 0;
 	}
 
-	return client.SubmitAudio(is, output_buffer,
-				  codec_context.bit_rate / 1000);
+	const uint16_t kbit_rate = codec_context.bit_rate / 1000;
+
+	if (!av_sample_fmt_is_planar(format) || channels == 1) {
+		/* already interleaved */
+		const auto *src = reinterpret_cast<const std::byte *>(frame.extended_data[0]);
+		return client.SubmitAudio(is,
+					  std::span{src + offset * frame_size,
+						    n_frames * frame_size},
+					  kbit_rate);
+	}
+
+	std::array<const void *, MAX_CHANNELS> planes;
+	for (unsigned c = 0; c < channels; ++c)
+		planes[c] = reinterpret_cast<const std::byte *>(frame.extended_data[c])
+			+ offset * sample_size;
+
+	do {
+		const auto dest = client.GetAudioBuffer(is, kbit_rate);
+		if (dest.empty())
+			return client.GetCommand();
+
+		const std::size_t n = std::min(n_frames,
+					       dest.size() / frame_size);
+		PcmInterleave(dest.data(), {planes.data(), channels},
+			      n, sample_size);
+
+		for (unsigned c = 0; c < channels; ++c)
+			planes[c] = static_cast<const std::byte *>(planes[c])
+				+ n * sample_size;
+		n_frames -= n;
+
+		auto cmd = client.CommitAudio(n * frame_size);
+		if (cmd != DecoderCommand::NONE)
+			return cmd;
+	} while (n_frames > 0);
+
+	return DecoderCommand::NONE;
 }
 
 static DecoderCommand
@@ -225,7 +276,6 @@ FfmpegReceiveFrames(DecoderClient &client, InputStream *is,
 		    AVCodecContext &codec_context,
 		    AVFrame &frame,
 		    size_t &skip_bytes,
-		    FfmpegBuffer &buffer,
 		    bool &eof)
 {
 	while (true) {
@@ -235,8 +285,7 @@ FfmpegReceiveFrames(DecoderClient &client, InputStream *is,
 		switch (err) {
 		case 0:
 			cmd = FfmpegSendFrame(client, is, codec_context,
-					      frame, skip_bytes,
-					      buffer);
+					      frame, skip_bytes);
 			if (cmd != DecoderCommand::NONE)
 				return cmd;
 
@@ -278,8 +327,7 @@ ffmpeg_send_packet(DecoderClient &client, InputStream *is,
 		   AVCodecContext &codec_context,
 		   const AVStream &stream,
 		   AVFrame &frame,
-		   uint64_t min_frame, size_t pcm_frame_size,
-		   FfmpegBuffer &buffer)
+		   uint64_t min_frame, size_t pcm_frame_size)
 {
 	size_t skip_bytes = 0;
 
@@ -319,7 +367,7 @@ ffmpeg_send_packet(DecoderClient &client, InputStream *is,
 
 	auto cmd = FfmpegReceiveFrames(client, is, codec_context,
 				       frame,
-				       skip_bytes, buffer, eof);
+				       skip_bytes, eof);
 
 	if (eof)
 		cmd = DecoderCommand::STOP;
@@ -528,8 +576,6 @@ FfmpegDecode(DecoderClient &client, InputStream *input,
 
 	Ffmpeg::Frame frame;
 
-	FfmpegBuffer interleaved_buffer;
-
 	uint64_t min_frame = 0;
 
 	DecoderCommand cmd = client.GetCommand();
@@ -571,8 +617,7 @@ FfmpegDecode(DecoderClient &client, InputStream *input,
 						 *codec_context,
 						 av_stream,
 						 *frame,
-						 min_frame, audio_format.GetFrameSize(),
-						 interleaved_buffer);
+						 min_frame, audio_format.GetFrameSize());
 			min_frame = 0;
 		} else
 			cmd = client.GetCommand();
@@ -10,6 +10,7 @@
 #include "Log.hxx"
 #include "input/InputStream.hxx"
 
+#include <algorithm> // for std::copy_n()
 #include <exception>
 
 bool
@@ -128,7 +129,9 @@ FlacDecoder::OnWrite(const FLAC__Frame &frame,
 	if (!initialized && !OnFirstFrame(frame.header))
 		return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
 
-	chunk = pcm_import.Import(buf, frame.header.blocksize);
+	const unsigned channels = pcm_import.GetAudioFormat().channels;
+	std::copy_n(buf, channels, pcm.begin());
+	n_pcm_frames = frame.header.blocksize;
 
 	kbit_rate = nbytes * 8 * frame.header.sample_rate /
 		(1000 * frame.header.blocksize);
@@ -14,8 +14,8 @@
 
 #include <FLAC/stream_decoder.h>
 
+#include <array>
 #include <cstddef>
-#include <span>
 
 struct FlacDecoder : public FlacInput {
 	/**
@@ -45,11 +45,19 @@ struct FlacDecoder : public FlacInput {
 	Tag tag;
 
 	/**
-	 * Decoded PCM data obtained by our libFLAC write callback.
-	 * If this is non-empty, then DecoderBridge::SubmitAudio()
-	 * should be called.
+	 * Decoded (planar) PCM data obtained by our libFLAC write
+	 * callback.  These point into libFLAC's own buffer, which
+	 * remains valid until the next frame gets decoded.  It gets
+	 * interleaved directly into the buffer obtained from
+	 * DecoderClient::GetAudioBuffer().
 	 */
-	std::span<const std::byte> chunk = {};
+	std::array<const FLAC__int32 *, FLAC__MAX_CHANNELS> pcm;
+
+	/**
+	 * The number of frames in #pcm which have not yet been
+	 * submitted to the #DecoderClient.
+	 */
+	std::size_t n_pcm_frames = 0;
 
 	FlacDecoder(DecoderClient &_client,
 		    InputStream &_input_stream) noexcept
@@ -13,6 +13,8 @@
 #include "fs/NarrowPath.hxx"
 #include "Log.hxx"
 
+#include <algorithm> // for std::min()
+
 static void
 flacPrintErroredState(FLAC__StreamDecoderState state) noexcept
 {
@@ -146,10 +148,46 @@ flac_decoder_initialize(FlacDecoder *data, FLAC__StreamDecoder *sd) noexcept
 	return data->initialized;
 }
 
+/**
+ * Interleave the decoded PCM data directly into the buffers
+ * obtained from DecoderClient::GetAudioBuffer().
+ */
+static DecoderCommand
+FlacSubmitAudio(DecoderClient &client, FlacDecoder &d) noexcept
+{
+	const auto &audio_format = d.pcm_import.GetAudioFormat();
+	const std::size_t frame_size = audio_format.GetFrameSize();
+
+	do {
+		const auto dest = client.GetAudioBuffer(d.GetInputStream(),
+							d.kbit_rate);
+		if (dest.empty()) {
+			d.n_pcm_frames = 0;
+			return client.GetCommand();
+		}
+
+		const std::size_t n_frames =
+			std::min(d.n_pcm_frames, dest.size() / frame_size);
+		d.pcm_import.Import(dest, d.pcm.data(), n_frames);
+
+		for (unsigned c = 0; c < audio_format.channels; ++c)
+			d.pcm[c] += n_frames;
+		d.n_pcm_frames -= n_frames;
+
+		auto cmd = client.CommitAudio(n_frames * frame_size);
+		if (cmd != DecoderCommand::NONE) {
+			d.n_pcm_frames = 0;
+			return cmd;
+		}
+	} while (d.n_pcm_frames > 0);
+
+	return DecoderCommand::NONE;
+}
+
 static DecoderCommand
 FlacSubmitToClient(DecoderClient &client, FlacDecoder &d) noexcept
 {
-	if (d.tag.IsEmpty() && d.chunk.empty())
+	if (d.tag.IsEmpty() && d.n_pcm_frames == 0)
 		return client.GetCommand();
 
 	if (!d.tag.IsEmpty()) {
@@ -160,13 +198,8 @@ FlacSubmitToClient(DecoderClient &client, FlacDecoder &d) noexcept
 			return cmd;
 	}
 
-	if (!d.chunk.empty()) {
-		auto cmd = client.SubmitAudio(d.GetInputStream(), d.chunk,
-					      d.kbit_rate);
-		d.chunk = {};
-		if (cmd != DecoderCommand::NONE)
-			return cmd;
-	}
+	if (d.n_pcm_frames > 0)
+		return FlacSubmitAudio(client, d);
 
 	return DecoderCommand::NONE;
 }
@@ -6,6 +6,7 @@
 #include "lib/xiph/FlacAudioFormat.hxx"
 #include "lib/fmt/RuntimeError.hxx"
 
+#include <cassert>
 #include <utility> // for std::unreachable()
 
 void
@@ -52,34 +53,28 @@ FlacImport(T *dest, const FLAC__int32 *const src[], size_t n_frames,
 		FlacImportAny(dest, src, n_frames, n_channels);
 }
 
-template<typename T>
-static std::span<const std::byte>
-FlacImport(PcmBuffer &buffer, const FLAC__int32 *const src[], size_t n_frames,
-	   unsigned n_channels) noexcept
+void
+FlacPcmImport::Import(std::span<std::byte> dest,
+		      const FLAC__int32 *const src[], size_t n_frames) noexcept
 {
-	size_t n_samples = n_frames * n_channels;
-	size_t dest_size = n_samples * sizeof(T);
-	T *dest = (T *)buffer.Get(dest_size);
-	FlacImport(dest, src, n_frames, n_channels);
-	return std::as_bytes(std::span{dest, n_samples});
-}
+	assert(dest.size() >= n_frames * audio_format.GetFrameSize());
 
-std::span<const std::byte>
-FlacPcmImport::Import(const FLAC__int32 *const src[], size_t n_frames) noexcept
-{
 	switch (audio_format.format) {
 	case SampleFormat::S16:
-		return FlacImport<int16_t>(buffer, src, n_frames,
-					   audio_format.channels);
+		FlacImport((int16_t *)dest.data(), src, n_frames,
+			   audio_format.channels);
+		return;
 
 	case SampleFormat::S24_P32:
 	case SampleFormat::S32:
-		return FlacImport<int32_t>(buffer, src, n_frames,
-					   audio_format.channels);
+		FlacImport((int32_t *)dest.data(), src, n_frames,
+			   audio_format.channels);
+		return;
 
 	case SampleFormat::S8:
-		return FlacImport<int8_t>(buffer, src, n_frames,
-					  audio_format.channels);
+		FlacImport((int8_t *)dest.data(), src, n_frames,
+			   audio_format.channels);
+		return;
 
 	case SampleFormat::FLOAT:
 	case SampleFormat::DSD:
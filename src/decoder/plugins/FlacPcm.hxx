@@ -4,7 +4,6 @@
 #ifndef MPD_FLAC_PCM_HXX
 #define MPD_FLAC_PCM_HXX
 
-#include "pcm/Buffer.hxx"
 #include "pcm/AudioFormat.hxx"
 
 #include <FLAC/ordinals.h>
@@ -17,8 +16,6 @@
  * MPD.
  */
 class FlacPcmImport {
-	PcmBuffer buffer;
-
 	AudioFormat audio_format;
 
 public:
@@ -32,8 +29,15 @@ public:
 		return audio_format;
 	}
 
-	std::span<const std::byte> Import(const FLAC__int32 *const src[],
-					  size_t n_frames) noexcept;
+	/**
+	 * Interleave the given frames into the specified buffer.
+	 *
+	 * @param dest the destination buffer; it must be large
+	 * enough for #n_frames frames
+	 */
+	void Import(std::span<std::byte> dest,
+		    const FLAC__int32 *const src[],
+		    size_t n_frames) noexcept;
 };
 
 #endif
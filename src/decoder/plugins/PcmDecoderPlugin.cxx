@@ -43,6 +43,58 @@ FillBuffer(DecoderClient &client, InputStream &is, B &buffer)
 	return true;
 }
 
+/**
+ * Read whole frames from the #InputStream.  A partial frame at the
+ * end of the stream is discarded.
+ *
+ * @return the number of bytes read (a multiple of the frame size)
+ */
+static size_t
+ReadFrames(DecoderClient &client, InputStream &is,
+	   std::span<std::byte> dest, size_t frame_size) noexcept
+{
+	size_t nbytes = decoder_read(client, is, dest);
+
+	if (const size_t rest = nbytes % frame_size; rest > 0) {
+		/* complete the last frame */
+		if (decoder_read_full(&client, is,
+				      dest.subspan(nbytes, frame_size - rest)))
+			nbytes += frame_size - rest;
+		else
+			nbytes -= rest;
+	}
+
+	return nbytes;
+}
+
+/**
+ * Read PCM data from the #InputStream directly into the buffer
+ * obtained from DecoderClient::GetAudioBuffer(), without an
+ * intermediate copy.
+ */
+static DecoderCommand
+ReadDirect(DecoderClient &client, InputStream &is, size_t frame_size,
+	   bool reverse_endian, bool &eof) noexcept
+{
+	const auto dest = client.GetAudioBuffer(is, 0);
+	if (dest.empty())
+		return client.GetCommand();
+
+	const size_t nbytes = ReadFrames(client, is, dest, frame_size);
+	if (nbytes == 0) {
+		eof = is.LockIsEOF();
+		return client.GetCommand();
+	}
+
+	if (reverse_endian)
+		/* make sure we deliver samples in host byte order */
+		reverse_bytes_16((uint16_t *)dest.data(),
+				 (uint16_t *)dest.data(),
+				 (uint16_t *)(dest.data() + nbytes));
+
+	return client.CommitAudio(nbytes);
+}
+
 static void
 pcm_stream_decode(DecoderClient &client, InputStream &is)
 {
@@ -165,22 +217,25 @@ pcm_stream_decode(DecoderClient &client, InputStream &is)
 
 	DecoderCommand cmd;
 	do {
-		if (!FillBuffer(client, is, buffer))
-			break;
-
-		auto r = buffer.Read();
-		/* round down to the nearest frame size, because we
-		   must not pass partial frames to
-		   DecoderClient::SubmitAudio() */
-		r = r.first(r.size() - r.size() % in_frame_size);
-		buffer.Consume(r.size());
-
-		if (reverse_endian)
-			/* make sure we deliver samples in host byte order */
-			reverse_bytes_16((uint16_t *)r.data(),
-					 (uint16_t *)r.data(),
-					 (uint16_t *)(r.data() + r.size()));
-		else if (l24) {
+		if (!l24) {
+			/* no conversion needed: read straight into
+			   the MusicPipe */
+			bool eof = false;
+			cmd = ReadDirect(client, is, in_frame_size,
+					 reverse_endian, eof);
+			if (eof)
+				break;
+		} else {
+			if (!FillBuffer(client, is, buffer))
+				break;
+
+			auto r = buffer.Read();
+			/* round down to the nearest frame size,
+			   because we must not pass partial frames to
+			   DecoderClient::SubmitAudio() */
+			r = r.first(r.size() - r.size() % in_frame_size);
+			buffer.Consume(r.size());
+
 			/* convert big-endian packed 24 bit
 			   (audio/L24) to native-endian 24 bit (in 32
 			   bit integers) */
@@ -191,11 +246,12 @@ pcm_stream_decode(DecoderClient &client, InputStream &is)
 				(std::byte *)&unpack_buffer[0],
 				(r.size() / 3) * 4,
 			};
+
+			cmd = !r.empty()
+				? client.SubmitAudio(is, r, 0)
+				: client.GetCommand();
 		}
 
-		cmd = !r.empty()
-			? client.SubmitAudio(is, r, 0)
-			: client.GetCommand();
 		if (cmd == DecoderCommand::SEEK) {
 			uint64_t frame = client.GetSeekFrame();
 			offset_type offset = frame * in_frame_size;
@@ -50,6 +50,7 @@ FullyBufferedSocket::Flush() noexcept
 	if (output.empty()) {
 		idle_event.Cancel();
 		event.CancelWrite();
+		OnSocketOutputEmpty();
 	}
 
 	return true;
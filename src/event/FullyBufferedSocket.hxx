@@ -37,6 +37,15 @@ public:
 		return output.max_size();
 	}
 
+	/**
+	 * @return the number of bytes in the output buffer which
+	 * have not yet been sent to the socket
+	 */
+	[[gnu::pure]]
+	std::size_t GetOutputSize() const noexcept {
+		return output.size();
+	}
+
 private:
 	/**
 	 * @return the number of bytes written to the socket, 0 if the
@@ -60,6 +69,13 @@ protected:
 
 	void OnIdle() noexcept;
 
+	/**
+	 * Called after the output buffer has been sent completely to
+	 * the socket.  The implementation must not close or destroy
+	 * the socket.
+	 */
+	virtual void OnSocketOutputEmpty() noexcept {}
+
 	/* virtual methods from class BufferedSocket */
 	void OnSocketReady(unsigned flags) noexcept override;
 };
@@ -9,6 +9,7 @@
 #include "event/CoarseTimerEvent.hxx"
 
 #include <string>
+#include <string_view>
 
 /**
  * A helper class which maintains an #InputStream that is opened once
@@ -57,6 +58,16 @@ public:
 		return is.get();
 	}
 
+	/**
+	 * Is an #InputStream for the given URI currently open?  If
+	 * yes, then Open() will return it without calling the opener
+	 * function.
+	 */
+	[[gnu::pure]]
+	bool IsOpen(std::string_view _uri) const noexcept {
+		return is && uri == _uri;
+	}
+
 	void Close() noexcept;
 
 private:
@@ -16,4 +16,6 @@ InputCacheConfig::InputCacheConfig(const ConfigBlock &block)
 		size = size_param->With([](const char *s){
 			return ParseSize(s);
 		});
+
+	prefetch = block.GetBlockValue("prefetch", 1U);
 }
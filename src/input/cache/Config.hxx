@@ -11,6 +11,11 @@ struct ConfigBlock;
 struct InputCacheConfig {
 	size_t size;
 
+	/**
+	 * The number of upcoming songs to be prefetched.
+	 */
+	unsigned prefetch;
+
 	explicit InputCacheConfig(const ConfigBlock &block);
 };
 
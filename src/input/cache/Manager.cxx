@@ -18,7 +18,8 @@ InputCacheManager::ItemGetUri::operator()(const InputCacheItem &item) const noex
 }
 
 InputCacheManager::InputCacheManager(const InputCacheConfig &config) noexcept
-	:max_total_size(config.size)
+	:max_total_size(config.size),
+	 prefetch_count(config.prefetch)
 {
 }
 
@@ -66,28 +67,57 @@ InputCacheManager::Get(const char *uri, bool create)
 	if (!PathTraitsUTF8::IsAbsolute(uri))
 		return {};
 
-	if (auto iter = items_by_uri.find(uri); iter != items_by_uri.end()) {
-		auto &item = *iter;
-
-		/* refresh */
-		items_by_time.erase(items_by_time.iterator_to(item));
-		items_by_time.push_back(item);
-
-		// TODO revalidate the cache item using the file's mtime?
-		// TODO if cache item contains error, retry now?
-
-		return InputCacheLease(item);
+	if (auto lease = Find(uri)) {
+		if (create)
+			hits.fetch_add(1, std::memory_order_relaxed);
+		return lease;
 	}
 
 	if (!create)
 		return {};
 
+	misses.fetch_add(1, std::memory_order_relaxed);
+	return Create(uri);
+}
+
+InputCacheLease
+InputCacheManager::Find(const char *uri) noexcept
+{
+	auto iter = items_by_uri.find(uri);
+	if (iter == items_by_uri.end())
+		return {};
+
+	auto &item = *iter;
+	Refresh(item);
+
+	// TODO revalidate the cache item using the file's mtime?
+	// TODO if cache item contains error, retry now?
+
+	return InputCacheLease(item);
+}
+
+inline void
+InputCacheManager::Refresh(InputCacheItem &item) noexcept
+{
+	items_by_time.erase(items_by_time.iterator_to(item));
+	items_by_time.push_back(item);
+}
+
+InputCacheLease
+InputCacheManager::Create(const char *uri)
+{
 	// TODO: wait for "ready" without blocking here
 	auto is = InputStream::OpenReady(uri, mutex);
 
 	if (!IsEligible(*is))
 		return {};
 
+	return Insert(std::move(is));
+}
+
+InputCacheLease
+InputCacheManager::Insert(InputStreamPtr &&is) noexcept
+{
 	const size_t size = is->GetSize();
 	total_size += size;
 
@@ -100,10 +130,60 @@ InputCacheManager::Get(const char *uri, bool create)
 	return InputCacheLease(*item);
 }
 
-void
-InputCacheManager::Prefetch(const char *uri)
+size_t
+InputCacheManager::GetPrefetchBudget() const noexcept
 {
-	Get(uri, true);
+	size_t in_use = 0;
+	for (const auto &i : items_by_time)
+		if (i.IsInUse())
+			in_use += i.size();
+
+	return in_use < max_total_size ? max_total_size - in_use : 0;
+}
+
+bool
+InputCacheManager::Prefetch(const char *uri, size_t &budget)
+{
+	/* not using Get() because prefetching shall not affect the
+	   hit/miss counters */
+
+	if (!PathTraitsUTF8::IsAbsolute(uri))
+		return true;
+
+	if (auto iter = items_by_uri.find(uri); iter != items_by_uri.end()) {
+		auto &item = *iter;
+
+		/* items in use have already been subtracted by
+		   GetPrefetchBudget() */
+		if (!item.IsInUse()) {
+			if (item.size() > budget)
+				return false;
+
+			budget -= item.size();
+		}
+
+		Refresh(item);
+		return true;
+	}
+
+	if (budget == 0)
+		return false;
+
+	// TODO: wait for "ready" without blocking here
+	auto is = InputStream::OpenReady(uri, mutex);
+
+	if (!IsEligible(*is))
+		return true;
+
+	const size_t size = is->GetSize();
+	if (size > budget)
+		/* inserting this item would evict another one which
+		   was prefetched with this budget */
+		return false;
+
+	budget -= size;
+	Insert(std::move(is));
+	return true;
 }
 
 void
@@ -3,10 +3,13 @@
 
 #pragma once
 
+#include "input/Ptr.hxx"
 #include "thread/Mutex.hxx"
 #include "util/IntrusiveHashSet.hxx"
 #include "util/IntrusiveList.hxx"
 
+#include <atomic>
+#include <cstdint>
 #include <string_view>
 
 class InputStream;
@@ -21,6 +24,8 @@ struct InputCacheConfig;
 class InputCacheManager {
 	const size_t max_total_size;
 
+	const unsigned prefetch_count;
+
 	mutable Mutex mutex;
 
 	size_t total_size = 0;
@@ -37,12 +42,34 @@ class InputCacheManager {
 						   std::hash<std::string_view>,
 						   std::equal_to<std::string_view>>> items_by_uri;
 
+	/**
+	 * Statistics: how many Get() calls with create=true found
+	 * the file in the cache?  These are updated by the decoder
+	 * thread.
+	 */
+	std::atomic<uint_least64_t> hits{0}, misses{0};
+
 public:
 	explicit InputCacheManager(const InputCacheConfig &config) noexcept;
 	~InputCacheManager() noexcept;
 
 	void Flush() noexcept;
 
+	/**
+	 * The number of upcoming songs which shall be prefetched.
+	 */
+	unsigned GetPrefetchCount() const noexcept {
+		return prefetch_count;
+	}
+
+	uint_least64_t GetHits() const noexcept {
+		return hits.load(std::memory_order_relaxed);
+	}
+
+	uint_least64_t GetMisses() const noexcept {
+		return misses.load(std::memory_order_relaxed);
+	}
+
 	[[gnu::pure]]
 	bool Contains(const char *uri) noexcept;
 
@@ -57,12 +84,56 @@ public:
 	InputCacheLease Get(const char *uri, bool create);
 
 	/**
-	 * Shortcut for "Get(uri,true)", discarding the returned
-	 * lease.
+	 * The number of bytes which may be occupied by prefetched
+	 * items: the cache size minus the size of all items which are
+	 * currently in use.
+	 */
+	[[gnu::pure]]
+	size_t GetPrefetchBudget() const noexcept;
+
+	/**
+	 * Like "Get(uri,true)", discarding the returned lease, but
+	 * without updating the hit/miss counters.
+	 *
+	 * The size of the item is subtracted from the given budget
+	 * (see GetPrefetchBudget()).  If it does not fit, the item is
+	 * neither created nor refreshed; this way, prefetching
+	 * several songs in a row never evicts an item which was
+	 * prefetched earlier with the same budget.
+	 *
+	 * Throws if opening the #InputStream fails.
+	 *
+	 * @return false if the item does not fit into the budget
 	 */
-	void Prefetch(const char *uri);
+	bool Prefetch(const char *uri, size_t &budget);
 
 private:
+	/**
+	 * Look up an existing item and mark it as "recently used".
+	 *
+	 * @return a lease of the item or nullptr if there is no
+	 * such item
+	 */
+	InputCacheLease Find(const char *uri) noexcept;
+
+	/**
+	 * Mark the item as "recently used".
+	 */
+	void Refresh(InputCacheItem &item) noexcept;
+
+	/**
+	 * Create a new item.
+	 *
+	 * Throws if opening the #InputStream fails.
+	 */
+	InputCacheLease Create(const char *uri);
+
+	/**
+	 * Add a new item for the given (eligible) #InputStream,
+	 * evicting old items to make room for it.
+	 */
+	InputCacheLease Insert(InputStreamPtr &&is) noexcept;
+
 	/**
 	 * Check whether the given #InputStream can be stored in this
 	 * cache.
@@ -32,6 +32,7 @@ ChromaprintDecoderClient::Ready(AudioFormat audio_format, bool,
 {
 	/* feed the first two minutes into libchromaprint */
 	remaining_bytes = audio_format.TimeToSize(std::chrono::minutes(2));
+	frame_size = audio_format.GetFrameSize();
 
 	if (audio_format.format != SampleFormat::S16) {
 		const AudioFormat src_audio_format = audio_format;
@@ -66,6 +67,19 @@ ChromaprintDecoderClient::SubmitAudio(InputStream *,
 	return GetCommand();
 }
 
+std::span<std::byte>
+ChromaprintDecoderClient::GetAudioBuffer(InputStream *, uint16_t) noexcept
+{
+	assert(ready);
+
+	if (GetCommand() != DecoderCommand::NONE)
+		return {};
+
+	const std::size_t size = 4096 / frame_size * frame_size;
+	pending_audio = {audio_buffer.GetT<std::byte>(size), size};
+	return pending_audio;
+}
+
 size_t
 ChromaprintDecoderClient::Read(InputStream &is,
 			       std::span<std::byte> dest) noexcept
@@ -6,6 +6,7 @@
 
 #include "Context.hxx"
 #include "decoder/Client.hxx"
+#include "pcm/Buffer.hxx"
 #include "thread/Mutex.hxx"
 
 #include <cstdint>
@@ -23,6 +24,15 @@ class ChromaprintDecoderClient : public DecoderClient {
 
 	uint64_t remaining_bytes;
 
+	std::size_t frame_size;
+
+	/**
+	 * The buffer returned by GetAudioBuffer().
+	 */
+	PcmBuffer audio_buffer;
+
+	std::span<std::byte> pending_audio;
+
 protected:
 	/**
 	 * This is set when an I/O error occurs while decoding; it
@@ -81,6 +91,13 @@ public:
 				   std::span<const std::byte> audio,
 				   uint16_t kbit_rate) noexcept override;
 
+	std::span<std::byte> GetAudioBuffer(InputStream *is,
+					    uint16_t kbit_rate) noexcept override;
+
+	DecoderCommand CommitAudio(std::size_t nbytes) noexcept override {
+		return SubmitAudio(nullptr, pending_audio.first(nbytes), 0);
+	}
+
 	DecoderCommand SubmitTag(InputStream *, Tag &&) noexcept override {
 		return GetCommand();
 	}
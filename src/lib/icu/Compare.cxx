@@ -6,6 +6,11 @@
 #include "util/StringAPI.hxx"
 #include "util/StringCompare.hxx"
 
+#ifdef HAVE_ICU_CANONICALIZE
+#include "util/ASCII.hxx"
+#include "util/StringSearch.hxx"
+#endif
+
 #ifdef _WIN32
 #include "Win32.hxx"
 #include <windows.h>
@@ -16,7 +21,15 @@
 IcuCompare::IcuCompare(std::string_view _needle, bool _fold_case, bool _strip_diacritics) noexcept
 	:needle(IcuCanonicalize(_needle, _fold_case, _strip_diacritics)),
 	 fold_case(_fold_case),
-	 strip_diacritics(_strip_diacritics) {}
+	 strip_diacritics(_strip_diacritics),
+	 ascii_needle(needle != nullptr && StringIsASCII(needle.c_str())) {}
+
+/*
+ * Canonicalizing a pure ASCII string only converts upper case letters
+ * to lower case (if case folding is enabled); all other characters
+ * remain unmodified.  Therefore, ASCII haystacks can be compared
+ * without the expensive IcuCanonicalize() call.
+ */
 
 #elif defined(_WIN32)
 
@@ -46,6 +59,15 @@ bool
 IcuCompare::operator==(const char *haystack) const noexcept
 {
 #ifdef HAVE_ICU_CANONICALIZE
+	if (StringIsASCII(haystack)) {
+		if (!ascii_needle)
+			return false;
+
+		return fold_case
+			? StringEqualsCaseASCII(haystack, needle.c_str())
+			: StringIsEqual(haystack, needle.c_str());
+	}
+
 	return StringIsEqual(IcuCanonicalize(haystack, fold_case, strip_diacritics).c_str(), needle.c_str());
 #elif defined(_WIN32)
 	if (needle == nullptr)
@@ -72,8 +94,17 @@ bool
 IcuCompare::IsIn(const char *haystack) const noexcept
 {
 #ifdef HAVE_ICU_CANONICALIZE
-	return StringFind(IcuCanonicalize(haystack, fold_case, strip_diacritics).c_str(),
-			  needle.c_str()) != nullptr;
+	if (StringIsASCII(haystack)) {
+		if (!ascii_needle)
+			return false;
+
+		return (fold_case
+			? StringSearchIgnoreCaseASCII(haystack, needle)
+			: StringSearch(haystack, needle)) != nullptr;
+	}
+
+	return StringSearch(IcuCanonicalize(haystack, fold_case, strip_diacritics).c_str(),
+			    needle) != nullptr;
 #elif defined(_WIN32)
 	if (needle == nullptr)
 		/* the MultiByteToWideChar() call in the constructor
@@ -109,6 +140,15 @@ bool
 IcuCompare::StartsWith(const char *haystack) const noexcept
 {
 #ifdef HAVE_ICU_CANONICALIZE
+	if (StringIsASCII(haystack)) {
+		if (!ascii_needle)
+			return false;
+
+		return fold_case
+			? StringStartsWithCaseASCII(haystack, needle)
+			: StringStartsWith(haystack, needle);
+	}
+
 	return StringStartsWith(IcuCanonicalize(haystack, fold_case, strip_diacritics).c_str(),
 				needle);
 #elif defined(_WIN32)
@@ -28,6 +28,13 @@ class IcuCompare {
 	bool fold_case;
 	bool strip_diacritics;
 
+	/**
+	 * Does the (canonicalized) #needle consist only of ASCII
+	 * characters?  This enables a fast path for ASCII haystacks
+	 * which does not need to canonicalize them.
+	 */
+	bool ascii_needle = false;
+
 public:
 	IcuCompare() noexcept = default;
 
@@ -38,7 +45,8 @@ public:
 			? AllocatedString(src.needle)
 			: nullptr),
 		 fold_case(src.fold_case),
-		 strip_diacritics(src.strip_diacritics) {}
+		 strip_diacritics(src.strip_diacritics),
+		 ascii_needle(src.ascii_needle) {}
 
 	IcuCompare &operator=(const IcuCompare &src) noexcept {
 		needle = src
@@ -46,6 +54,7 @@ public:
 			: nullptr;
 		fold_case = src.fold_case;
 		strip_diacritics = src.strip_diacritics;
+		ascii_needle = src.ascii_needle;
 		return *this;
 	}
 
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: BSD-2-Clause
+// Copyright CM4all GmbH
+// author: Max Kellermann <max.kellermann@ionos.com>
+
+#include "RegexPointer.hxx"
+
+namespace {
+
+/**
+ * A match data block with room for just one ovector pair; that is
+ * enough for RegexPointer::Test(), which does not need captures.
+ */
+class ThreadMatchData {
+	pcre2_match_data_8 *const match_data =
+		pcre2_match_data_create_8(1, nullptr);
+
+public:
+	ThreadMatchData() noexcept = default;
+
+	~ThreadMatchData() noexcept {
+		if (match_data != nullptr)
+			pcre2_match_data_free_8(match_data);
+	}
+
+	ThreadMatchData(const ThreadMatchData &) = delete;
+	ThreadMatchData &operator=(const ThreadMatchData &) = delete;
+
+	pcre2_match_data_8 *Get() const noexcept {
+		return match_data;
+	}
+};
+
+} // anonymous namespace
+
+bool
+RegexPointer::Test(std::string_view s) const noexcept
+{
+	thread_local ThreadMatchData thread_match_data;
+
+	auto *const match_data = thread_match_data.Get();
+	if (match_data == nullptr) [[unlikely]]
+		/* out of memory; fall back to the allocating
+		   implementation */
+		return Match(s);
+
+	/* a return value of 0 means the ovector was too small for
+	   all captures, which is still a match */
+	const int n = jit
+		? pcre2_jit_match_8(re, (PCRE2_SPTR8)s.data(), s.size(),
+				    0, 0, match_data, nullptr)
+		: pcre2_match_8(re, (PCRE2_SPTR8)s.data(), s.size(),
+				0, 0, match_data, nullptr);
+	return n >= 0;
+}
@@ -16,11 +16,27 @@ protected:
 
 	unsigned n_capture = 0;
 
+	/**
+	 * Was the pattern compiled successfully by the JIT compiler?
+	 */
+	bool jit = false;
+
 public:
 	constexpr bool IsDefined() const noexcept {
 		return re != nullptr;
 	}
 
+	/**
+	 * Check whether the string matches, without returning
+	 * captures.  This is cheaper than Match() because it reuses
+	 * a per-thread match data block instead of allocating one
+	 * for each call, and it uses the JIT fast path.
+	 *
+	 * Not [[gnu::pure]] because it writes to the per-thread
+	 * match data block.
+	 */
+	bool Test(std::string_view s) const noexcept;
+
 	[[gnu::pure]]
 	MatchData Match(std::string_view s) const noexcept {
 		MatchData match_data{
@@ -21,7 +21,7 @@ UniqueRegex::Compile(const char *pattern, const int options)
 		throw Pcre::MakeError(error_number, msg);
 	}
 
-	pcre2_jit_compile_8(re, PCRE2_JIT_COMPLETE);
+	jit = pcre2_jit_compile_8(re, PCRE2_JIT_COMPLETE) == 0;
 
 	if (int n; (options & PCRE2_NO_AUTO_CAPTURE) == 0 &&
 	    pcre2_pattern_info_8(re, PCRE2_INFO_CAPTURECOUNT, &n) == 0)
@@ -84,7 +84,7 @@ AnalyzeMixRamp(const MusicPipe &pipe, const AudioFormat &audio_format,
 
 	MixRampAnalyzer a;
 	do {
-		a.Process(FromBytesStrict<const ReplayGainAnalyzer::Frame>({chunk->data, chunk->length}));
+		a.Process(FromBytesStrict<const ReplayGainAnalyzer::Frame>(chunk->ReadData()));
 	} while ((chunk = chunk->next.get()) != nullptr);
 
 	return ToString(a.GetResult(), a.GetTime(), direction);
@@ -6,6 +6,8 @@
 
 #include "Chrono.hxx"
 
+#include <cstddef>
+
 struct AudioFormat;
 class SignedSongTime;
 
@@ -58,6 +60,7 @@ struct CrossFadeSettings {
 	 * @param mixramp_start the next songs mixramp_start tag
 	 * @param mixramp_prev_end the last songs mixramp_end setting
 	 * @param af the audio format of the new song
+	 * @param chunk_data_size the number of data bytes in each chunk
 	 * @param max_chunks the maximum number of chunks
 	 * @return the number of chunks for crossfading, or 0 if cross fading
 	 * should be disabled for this song change
@@ -67,6 +70,7 @@ struct CrossFadeSettings {
 			   const char *mixramp_start,
 			   const char *mixramp_prev_end,
 			   AudioFormat af,
+			   std::size_t chunk_data_size,
 			   unsigned max_chunks) const noexcept;
 
 private:
@@ -508,9 +508,11 @@ Player::MixRampScannerReady() noexcept
 	if (dc.GetMixRampStart() == nullptr) {
 		const std::size_t want_pipe_bytes =
 			dc.out_audio_format.TimeToSize(std::chrono::seconds{20});
+		const std::size_t chunk_data_size =
+			buffer.GetChunkDataSize();
 		const std::size_t want_pipe_chunks =
-			std::min((want_pipe_bytes + sizeof(MusicChunk::data) - 1)
-				 / sizeof(MusicChunk::data),
+			std::min((want_pipe_bytes + chunk_data_size - 1)
+				 / chunk_data_size,
 				 buffer.GetSize() / std::size_t{3});
 
 		if (dc.pipe->GetSize() < want_pipe_chunks) {
@@ -594,9 +596,11 @@ Player::CheckDecoderStartup(std::unique_lock<Mutex> &lock) noexcept
 
 		const size_t buffer_before_play_size =
 			play_audio_format.TimeToSize(buffer_before_play_duration);
+		const std::size_t chunk_data_size =
+			buffer.GetChunkDataSize();
 		buffer_before_play =
-			(buffer_before_play_size + sizeof(MusicChunk::data) - 1)
-			/ sizeof(MusicChunk::data);
+			(buffer_before_play_size + chunk_data_size - 1)
+			/ chunk_data_size;
 
 		pc.listener.OnPlayerStateChanged();
 
@@ -889,6 +893,7 @@ Player::CheckCrossFade() noexcept
 					dc.GetMixRampStart(),
 					dc.GetMixRampPreviousEnd(),
 					play_audio_format,
+					buffer.GetChunkDataSize(),
 					buffer.GetSize() -
 					buffer_before_play);
 	if (cross_fade_chunks > 0)
@@ -1258,7 +1263,7 @@ try {
 			  config.replay_gain);
 	dc.StartThread();
 
-	MusicBuffer buffer{config.buffer_chunks};
+	MusicBuffer buffer{config.buffer_chunks, config.chunk_size};
 
 	std::unique_lock lock{mutex};
 
@@ -12,14 +12,11 @@
 #include "input/Error.hxx"
 #include "thread/Mutex.hxx"
 #include "fs/Traits.hxx"
-#include "Log.hxx"
-
-#include "db/Features.hxx" // for ENABLE_DATABASE
-#ifdef ENABLE_DATABASE
 #include "SongLoader.hxx"
-#endif
+#include "Log.hxx"
 
 #include <memory>
+#include <vector>
 
 void
 playlist_load_into_queue(const char *uri, SongEnumerator &e,
@@ -33,8 +30,13 @@ playlist_load_into_queue(const char *uri, SongEnumerator &e,
 		? PathTraitsUTF8::GetParent(uri)
 		: ".";
 
+	/* first collect all songs, so they can be loaded all at
+	   once with SongLoader::LoadSongs() */
+	std::vector<std::unique_ptr<DetachedSong>> songs;
+	std::vector<const char *> uris;
+
 	std::unique_ptr<DetachedSong> song;
-	for (unsigned i = 0, failures = 0;
+	for (unsigned i = 0;
 	     i < end_index && (song = e.NextSong()) != nullptr;
 	     ++i) {
 		if (i < start_index) {
@@ -42,18 +44,30 @@ playlist_load_into_queue(const char *uri, SongEnumerator &e,
 			continue;
 		}
 
-		if (!playlist_check_translate_song(*song, base_uri,
-						   loader)) {
+		playlist_translate_song_uri(*song, base_uri);
+		songs.push_back(std::move(song));
+	}
+
+	uris.reserve(songs.size());
+	for (const auto &i : songs)
+		uris.push_back(i->GetURI());
+
+	auto loaded = loader.LoadSongs(uris);
+
+	unsigned failures = 0;
+	for (std::size_t i = 0; i < songs.size(); ++i) {
+		if (!loaded[i]) {
 			failures += 1;
 			if (failures < max_log_msgs) {
-				FmtError(playlist_domain, "Failed to load {:?}.", song->GetURI());
+				FmtError(playlist_domain, "Failed to load {:?}.", songs[i]->GetURI());
 			} else if (failures == max_log_msgs) {
 				LogError(playlist_domain, "Further errors for this playlist will not be logged.");
 			}
 			continue;
 		}
 
-		dest.AppendSong(pc, std::move(*song));
+		playlist_merge_loaded_song(*songs[i], *loaded[i]);
+		dest.AppendSong(pc, std::move(*songs[i]));
 	}
 	dest.SetLastLoadedPlaylist(uri);
 }
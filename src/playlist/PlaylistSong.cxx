@@ -38,24 +38,29 @@ merge_song_metadata(DetachedSong &add, const DetachedSong &base) noexcept
 		add.SetAudioFormat(base.GetAudioFormat());
 }
 
+void
+playlist_merge_loaded_song(DetachedSong &song,
+			   const DetachedSong &loaded) noexcept
+{
+	song.SetURI(loaded.GetURI());
+	if (!song.HasRealURI() && loaded.HasRealURI())
+		song.SetRealURI(loaded.GetRealURI());
+
+	merge_song_metadata(song, loaded);
+}
+
 static bool
 playlist_check_load_song(DetachedSong &song, const SongLoader &loader) noexcept
 try {
-	DetachedSong tmp = loader.LoadSong(song.GetURI());
-
-	song.SetURI(tmp.GetURI());
-	if (!song.HasRealURI() && tmp.HasRealURI())
-		song.SetRealURI(tmp.GetRealURI());
-
-	merge_song_metadata(song, tmp);
+	playlist_merge_loaded_song(song, loader.LoadSong(song.GetURI()));
 	return true;
 } catch (...) {
 	return false;
 }
 
-bool
-playlist_check_translate_song(DetachedSong &song, std::string_view base_uri,
-			      const SongLoader &loader) noexcept
+void
+playlist_translate_song_uri(DetachedSong &song,
+			    std::string_view base_uri) noexcept
 {
 	if (base_uri.compare(".") == 0)
 		/* PathTraitsUTF8::GetParent() returns "." when there
@@ -90,6 +95,12 @@ playlist_check_translate_song(DetachedSong &song, std::string_view base_uri,
 	/* Remove dot segments */
 	std::string new_uri = uri_squash_dot_segments(uri);
 	song.SetURI(std::move(new_uri));
+}
 
+bool
+playlist_check_translate_song(DetachedSong &song, std::string_view base_uri,
+			      const SongLoader &loader) noexcept
+{
+	playlist_translate_song_uri(song, base_uri);
 	return playlist_check_load_song(song, loader);
 }
@@ -19,4 +19,21 @@ bool
 playlist_check_translate_song(DetachedSong &song, std::string_view base_uri,
 			      const SongLoader &loader) noexcept;
 
+/**
+ * The first half of playlist_check_translate_song(): make the song
+ * URI absolute (relative to the playlist's base URI) and normalize
+ * it, but don't load it yet.
+ */
+void
+playlist_translate_song_uri(DetachedSong &song,
+			    std::string_view base_uri) noexcept;
+
+/**
+ * The second half of playlist_check_translate_song(): merge the
+ * song which was loaded by #SongLoader into the playlist's song.
+ */
+void
+playlist_merge_loaded_song(DetachedSong &song,
+			   const DetachedSong &loaded) noexcept;
+
 #endif
@@ -223,6 +223,12 @@ protected:
 	void DeleteInternal(PlayerControl &pc,
 			    unsigned song, const DetachedSong **queued_p) noexcept;
 
+	/**
+	 * Delete a range of songs which does not contain the current
+	 * song, and adjust #current.
+	 */
+	void DeleteRangeInternal(RangeArg range) noexcept;
+
 public:
 	void DeletePosition(PlayerControl &pc, unsigned position);
 
@@ -264,14 +264,44 @@ playlist::DeleteRange(PlayerControl &pc, RangeArg range)
 
 	const DetachedSong *queued_song = GetQueuedSong();
 
-	do {
-		DeleteInternal(pc, --range.end, &queued_song);
-	} while (range.end != range.start);
+	const int current_position = current >= 0
+		? int(queue.OrderToPosition(current))
+		: -1;
+
+	if (current_position >= 0 && range.Contains(current_position)) {
+		/* delete all other songs first, so DeleteInternal()
+		   picks the successor of the current song among the
+		   remaining ones */
+		DeleteRangeInternal({unsigned(current_position) + 1, range.end});
+		DeleteRangeInternal({range.start, unsigned(current_position)});
+		DeleteInternal(pc, range.start, &queued_song);
+	} else
+		DeleteRangeInternal(range);
 
 	UpdateQueuedSong(pc, queued_song);
 	OnModified();
 }
 
+void
+playlist::DeleteRangeInternal(RangeArg range) noexcept
+{
+	assert(current < 0 ||
+	       !range.Contains(queue.OrderToPosition(current)));
+
+	if (current > 0) {
+		/* count the deleted songs which are before the
+		   current one in "order" */
+		unsigned n = 0;
+		for (unsigned i = 0; i < unsigned(current); ++i)
+			if (range.Contains(queue.OrderToPosition(i)))
+				++n;
+
+		current -= n;
+	}
+
+	queue.DeleteRange(range.start, range.end);
+}
+
 void
 playlist::DeleteId(PlayerControl &pc, unsigned id)
 {
@@ -19,6 +19,7 @@
 #include "util/StringAPI.hxx"
 #include "util/StringCompare.hxx"
 #include "util/CNumberParser.hxx"
+#include "util/ScopeExit.hxx"
 #include "Log.hxx"
 
 #include <fmt/format.h>
@@ -103,15 +104,27 @@ playlist_state_load(LineReader &file, const SongLoader &song_loader,
 		return;
 	}
 
-	while (!StringStartsWith(line, PLAYLIST_STATE_FILE_PLAYLIST_END)) {
-		queue_load_song(file, song_loader, line, playlist.queue);
-
-		line = file.ReadLine();
-		if (line == nullptr) {
-			LogWarning(playlist_domain,
-				   "'" PLAYLIST_STATE_FILE_PLAYLIST_END
-				   "' not found in state file");
-			break;
+	{
+		/* parse all songs first, so they can be looked up
+		   all at once; this is also done if parsing fails,
+		   to keep the songs which were parsed
+		   successfully */
+		std::vector<SavedQueueSong> songs;
+		AtScopeExit(&song_loader, &songs, &playlist) {
+			queue_load_songs(song_loader, std::move(songs),
+					 playlist.queue);
+		};
+
+		while (!StringStartsWith(line, PLAYLIST_STATE_FILE_PLAYLIST_END)) {
+			queue_load_song(file, line, songs);
+
+			line = file.ReadLine();
+			if (line == nullptr) {
+				LogWarning(playlist_domain,
+					   "'" PLAYLIST_STATE_FILE_PLAYLIST_END
+					   "' not found in state file");
+				break;
+			}
 		}
 	}
 
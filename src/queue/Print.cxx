@@ -6,6 +6,7 @@
 #include "Selection.hxx"
 #include "song/Filter.hxx"
 #include "SongPrint.hxx"
+#include "SongRecord.hxx"
 #include "song/DetachedSong.hxx"
 #include "song/LightSong.hxx"
 #include "tag/Sort.hxx"
@@ -28,6 +29,21 @@ static void
 queue_print_song_info(Response &r, const Queue &queue,
 		      unsigned position)
 {
+	if (r.ProtocolFeatureEnabled(PF_BINARY_SONGS)) {
+		SongRecordBuilder record;
+		song_record_add(record, r, queue.Get(position));
+		record.Add(SongRecordField::POS, position);
+		record.Add(SongRecordField::ID,
+			   queue.PositionToId(position));
+
+		if (uint8_t priority = queue.GetPriorityAtPosition(position);
+		    priority != 0)
+			record.Add(SongRecordField::PRIO, priority);
+
+		record.Send(r);
+		return;
+	}
+
 	song_print_info(r, queue.Get(position));
 	r.Fmt("Pos: {}\nId: {}\n",
 	      position, queue.PositionToId(position));
@@ -69,9 +85,8 @@ queue_print_changes_info(Response &r, const Queue &queue,
 	assert(start <= end);
 	assert(end <= queue.GetLength());
 
-	for (unsigned i = start; i < end; i++)
-		if (queue.IsNewerAtPosition(i, version))
-			queue_print_song_info(r, queue, i);
+	for (const unsigned i : queue.FindChangedPositions(version, start, end))
+		queue_print_song_info(r, queue, i);
 }
 
 void
@@ -82,10 +97,9 @@ queue_print_changes_position(Response &r, const Queue &queue,
 	assert(start <= end);
 	assert(end <= queue.GetLength());
 
-	for (unsigned i = start; i < end; i++)
-		if (queue.IsNewerAtPosition(i, version))
-			r.Fmt("cpos: {}\nId: {}\n",
-			      i, queue.PositionToId(i));
+	for (const unsigned i : queue.FindChangedPositions(version, start, end))
+		r.Fmt("cpos: {}\nId: {}\n",
+		      i, queue.PositionToId(i));
 }
 
 [[gnu::pure]]
@@ -6,12 +6,17 @@
 #include "song/LightSong.hxx"
 
 #include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
 
 Queue::Queue(unsigned _max_length) noexcept
 	:max_length(_max_length),
 	 items(new Item[max_length]),
 	 order(new unsigned[max_length]),
-	 id_table(max_length * HASH_MULT)
+	 inverse_order(new unsigned[max_length]),
+	 id_table(max_length * HASH_MULT),
+	 change_log(new Change[CHANGE_LOG_SIZE])
 {
 }
 
@@ -21,6 +26,8 @@ Queue::~Queue() noexcept
 
 	delete[] items;
 	delete[] order;
+	delete[] inverse_order;
+	delete[] change_log;
 }
 
 LightSong
@@ -62,7 +69,70 @@ Queue::IncrementVersion() noexcept
 			items[i].version = 0;
 
 		version = 1;
+
+		/* the #change_log is useless until the next Clear()
+		   call, because all items with version 0 are
+		   considered "changed" */
+		change_log_version = std::numeric_limits<uint32_t>::max();
+	}
+}
+
+void
+Queue::LogChange(unsigned id) noexcept
+{
+	auto &change = change_log[change_log_next];
+
+	if (change_log_size == CHANGE_LOG_SIZE)
+		/* overwriting the oldest entry; from now on, the
+		   log is incomplete for this version */
+		change_log_version = std::max(change_log_version,
+					      change.version + 1);
+	else
+		++change_log_size;
+
+	change = {version, id};
+	change_log_next = (change_log_next + 1) % CHANGE_LOG_SIZE;
+}
+
+std::vector<unsigned>
+Queue::FindChangedPositions(uint32_t _version,
+			    unsigned start, unsigned end) const noexcept
+{
+	assert(start <= end);
+	assert(end <= length);
+
+	std::vector<unsigned> result;
+
+	if (_version > version || _version < change_log_version) {
+		/* the log is incomplete; scan the whole range */
+		for (unsigned i = start; i < end; ++i)
+			if (IsNewerAtPosition(i, _version))
+				result.push_back(i);
+
+		return result;
 	}
+
+	/* walk the log backwards, from the newest entry to the
+	   oldest one which is still relevant */
+	for (unsigned n = 0, i = change_log_next; n < change_log_size; ++n) {
+		i = (i + CHANGE_LOG_SIZE - 1) % CHANGE_LOG_SIZE;
+
+		const auto &change = change_log[i];
+		if (change.version < _version)
+			break;
+
+		/* the id may have been deleted or reused
+		   meanwhile, therefore double-check with
+		   IsNewerAtPosition() */
+		const int position = id_table.IdToPosition(change.id);
+		if (position >= int(start) && position < int(end) &&
+		    IsNewerAtPosition(position, _version))
+			result.push_back(position);
+	}
+
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
 }
 
 void
@@ -85,10 +155,10 @@ Queue::Append(DetachedSong &&song, uint8_t priority) noexcept
 	auto &item = items[position];
 	item.song = new DetachedSong(std::move(song));
 	item.id = id;
-	item.version = version;
 	item.priority = priority;
+	Modify(item);
 
-	order[position] = position;
+	order[position] = inverse_order[position] = position;
 
 	return id;
 }
@@ -101,8 +171,8 @@ Queue::SwapPositions(unsigned position1, unsigned position2) noexcept
 
 	std::swap(items[position1], items[position2]);
 
-	items[position1].version = version;
-	items[position2].version = version;
+	Modify(items[position1]);
+	Modify(items[position2]);
 
 	id_table.Move(id1, position2);
 	id_table.Move(id2, position1);
@@ -127,7 +197,7 @@ Queue::MovePostion(unsigned from, unsigned to) noexcept
 
 	id_table.Move(tmp.id, to);
 	items[to] = tmp;
-	items[to].version = version;
+	Modify(items[to]);
 
 	/* now deal with order */
 
@@ -141,6 +211,8 @@ Queue::MovePostion(unsigned from, unsigned to) noexcept
 			else if (from == order[i])
 				order[i] = to;
 		}
+
+		UpdateInverseOrder(0, length);
 	}
 }
 
@@ -168,7 +240,7 @@ Queue::MoveRange(unsigned start, unsigned end, unsigned to) noexcept
 	{
 		id_table.Move(tmp[i - start].id, to + i - start);
 		items[to + i - start] = tmp[i-start];
-		items[to + i - start].version = version;
+		Modify(items[to + i - start]);
 	}
 
 	if (random) {
@@ -184,6 +256,8 @@ Queue::MoveRange(unsigned start, unsigned end, unsigned to) noexcept
 			else if (start <= order[i] && order[i] < end)
 				order[i] += to - start;
 		}
+
+		UpdateInverseOrder(0, length);
 	}
 }
 
@@ -204,6 +278,9 @@ Queue::MoveOrder(unsigned from_order, unsigned to_order) noexcept
 	}
 
 	order[to_order] = from_position;
+
+	UpdateInverseOrder(std::min(from_order, to_order),
+			   std::max(from_order, to_order) + 1);
 	return to_order;
 }
 
@@ -226,36 +303,44 @@ Queue::MoveOrderAfter(unsigned from_order, unsigned to_order) noexcept
 }
 
 void
-Queue::DeletePosition(unsigned position) noexcept
+Queue::DeleteRange(unsigned start, unsigned end) noexcept
 {
-	assert(position < length);
-
-	delete items[position].song;
+	assert(start <= end);
+	assert(end <= length);
 
-	const unsigned id = PositionToId(position);
-	const unsigned _order = PositionToOrder(position);
+	const unsigned n = end - start;
+	if (n == 0)
+		return;
 
-	--length;
+	/* free the songs and release their ids */
 
-	/* release the song id */
+	for (unsigned i = start; i < end; i++) {
+		delete items[i].song;
+		id_table.Erase(items[i].id);
+	}
 
-	id_table.Erase(id);
+	/* close the gap in the songs array */
 
-	/* delete song from songs array */
+	for (unsigned i = end; i < length; i++)
+		MoveItemTo(i, i - n);
 
-	for (unsigned i = position; i < length; i++)
-		MoveItemTo(i + 1, i);
+	/* remove the entries from the order array and readjust
+	   the remaining values in the same pass */
 
-	/* delete the entry from the order array */
+	unsigned dest = 0;
+	for (unsigned i = 0; i < length; i++) {
+		const unsigned position = order[i];
+		if (position < start)
+			order[dest++] = position;
+		else if (position >= end)
+			order[dest++] = position - n;
+	}
 
-	for (unsigned i = _order; i < length; i++)
-		order[i] = order[i + 1];
+	assert(dest == length - n);
 
-	/* readjust values in the order array */
+	length -= n;
 
-	for (unsigned i = 0; i < length; i++)
-		if (order[i] > position)
-			--order[i];
+	UpdateInverseOrder(0, length);
 }
 
 void
@@ -271,6 +356,11 @@ Queue::Clear() noexcept
 
 	length = 0;
 	last_loaded_playlist.clear();
+
+	/* all items which will be added from now on will be
+	   logged */
+	change_log_size = 0;
+	change_log_version = 0;
 }
 
 static void
@@ -282,14 +372,33 @@ queue_sort_order_by_priority(Queue *queue,
 	assert(start <= end);
 	assert(end <= queue->length);
 
-	auto cmp = [queue](unsigned a_pos, unsigned b_pos){
-		const Queue::Item &a = queue->items[a_pos];
-		const Queue::Item &b = queue->items[b_pos];
+	/* this is a counting sort over the 256 possible priority
+	   values, which is O(n) unlike std::stable_sort() */
+
+	std::array<unsigned, 256> count{};
+	for (unsigned i = start; i < end; ++i)
+		++count[queue->items[queue->order[i]].priority];
 
-		return a.priority > b.priority;
-	};
+	if (start == end ||
+	    count[queue->items[queue->order[start]].priority] == end - start)
+		/* all items have the same priority: nothing to do */
+		return;
+
+	/* convert the counters to offsets, highest priority first */
+	std::array<unsigned, 256> offset;
+	unsigned sum = 0;
+	for (unsigned priority = count.size(); priority-- > 0;) {
+		offset[priority] = sum;
+		sum += count[priority];
+	}
+
+	const auto tmp = std::make_unique_for_overwrite<unsigned[]>(end - start);
+	for (unsigned i = start; i < end; ++i) {
+		const unsigned position = queue->order[i];
+		tmp[offset[queue->items[position].priority]++] = position;
+	}
 
-	std::stable_sort(queue->order + start, queue->order + end, cmp);
+	std::copy_n(tmp.get(), end - start, queue->order + start);
 }
 
 void
@@ -301,6 +410,7 @@ Queue::ShuffleOrderRange(unsigned start, unsigned end) noexcept
 
 	rand.AutoCreate();
 	std::shuffle(order + start, order + end, rand);
+	UpdateInverseOrder(start, end);
 }
 
 /**
@@ -317,7 +427,9 @@ Queue::ShuffleOrderRangeWithPriority(unsigned start, unsigned end) noexcept
 	if (start == end)
 		return;
 
-	/* first group the range by priority */
+	/* first group the range by priority (this leaves
+	   #inverse_order stale, but ShuffleOrderRange() below
+	   updates it for each group) */
 	queue_sort_order_by_priority(this, start, end);
 
 	/* now shuffle each priority group */
@@ -437,8 +549,8 @@ Queue::SetPriority(unsigned position, uint8_t priority, int after_order,
 	if (old_priority == priority)
 		return false;
 
-	item->version = version;
 	item->priority = priority;
+	Modify(*item);
 
 	if (!random || !reorder)
 		/* don't reorder if not in random mode */
@@ -12,6 +12,7 @@
 #include <cassert>
 #include <cstdint>
 #include <utility>
+#include <vector>
 
 struct LightSong;
 class DetachedSong;
@@ -33,6 +34,11 @@ struct Queue {
 	 */
 	static constexpr unsigned HASH_MULT = 4;
 
+	/**
+	 * The number of entries in the #change_log.
+	 */
+	static constexpr unsigned CHANGE_LOG_SIZE = 4096;
+
 	/**
 	 * One element of the queue: basically a song plus some queue specific
 	 * information attached.
@@ -54,6 +60,17 @@ struct Queue {
 		uint8_t priority;
 	};
 
+	/**
+	 * One entry of the #change_log.
+	 */
+	struct Change {
+		/** the queue version at the time of the modification */
+		uint32_t version;
+
+		/** the id of the modified item */
+		unsigned id;
+	};
+
 	/** configured maximum length of the queue */
 	const unsigned max_length;
 
@@ -69,9 +86,35 @@ struct Queue {
 	/** map order numbers to positions */
 	unsigned *const order;
 
+	/**
+	 * Map positions to order numbers; this is the inverse of
+	 * #order, which makes PositionToOrder() cheap.
+	 */
+	unsigned *const inverse_order;
+
 	/** map song ids to positions */
 	IdTable id_table;
 
+	/**
+	 * A ring buffer of recent modifications, which allows
+	 * FindChangedPositions() to avoid scanning the whole queue.
+	 * The entries are sorted by version.
+	 */
+	Change *const change_log;
+
+	/** the index of the next #change_log entry to be written */
+	unsigned change_log_next = 0;
+
+	/** the number of valid #change_log entries */
+	unsigned change_log_size = 0;
+
+	/**
+	 * All modifications with this version number or newer are
+	 * in the #change_log.  It grows when old entries get
+	 * overwritten.
+	 */
+	uint32_t change_log_version = 0;
+
 	/** repeat playback when the end of the queue has been
 	    reached? */
 	bool repeat = false;
@@ -153,13 +196,9 @@ struct Queue {
 	[[gnu::pure]]
 	unsigned PositionToOrder(unsigned position) const noexcept {
 		assert(position < length);
+		assert(order[inverse_order[position]] == position);
 
-		for (unsigned i = 0;; ++i) {
-			assert(i < length);
-
-			if (order[i] == position)
-				return i;
-		}
+		return inverse_order[position];
 	}
 
 	[[gnu::pure]]
@@ -213,6 +252,20 @@ struct Queue {
 			items[position].version == 0;
 	}
 
+	/**
+	 * Find all positions in the given range which are newer than
+	 * the specified version (see IsNewerAtPosition()).  This
+	 * consults the #change_log if possible, and falls back to
+	 * scanning the range if the log does not go back far
+	 * enough.
+	 *
+	 * @return a sorted list of positions
+	 */
+	[[gnu::pure]]
+	std::vector<unsigned> FindChangedPositions(uint32_t _version,
+						   unsigned start,
+						   unsigned end) const noexcept;
+
 	/**
 	 * Returns the order number following the specified one.  This takes
 	 * end of queue and "repeat" mode into account.
@@ -236,7 +289,7 @@ struct Queue {
 	void ModifyAtPosition(unsigned position) noexcept {
 		assert(position < length);
 
-		items[position].version = version;
+		Modify(items[position]);
 	}
 
 	/**
@@ -268,6 +321,8 @@ struct Queue {
 	 */
 	void SwapOrders(unsigned order1, unsigned order2) noexcept {
 		std::swap(order[order1], order[order2]);
+		inverse_order[order[order1]] = order1;
+		inverse_order[order[order2]] = order2;
 	}
 
 	/**
@@ -308,7 +363,16 @@ struct Queue {
 	/**
 	 * Removes a song from the playlist.
 	 */
-	void DeletePosition(unsigned position) noexcept;
+	void DeletePosition(unsigned position) noexcept {
+		DeleteRange(position, position + 1);
+	}
+
+	/**
+	 * Removes a range of songs from the playlist.  This shifts
+	 * the following items and renumbers the "order" array only
+	 * once, regardless of the size of the range.
+	 */
+	void DeleteRange(unsigned start, unsigned end) noexcept;
 
 	/**
 	 * Removes all songs from the playlist.
@@ -320,7 +384,7 @@ struct Queue {
 	 */
 	void RestoreOrder() noexcept {
 		for (unsigned i = 0; i < length; ++i)
-			order[i] = i;
+			order[i] = inverse_order[i] = i;
 	}
 
 	/**
@@ -365,11 +429,33 @@ struct Queue {
 			      uint8_t priority, int after_order) noexcept;
 
 private:
+	/**
+	 * Update #inverse_order after the specified range of #order
+	 * has been modified.
+	 */
+	void UpdateInverseOrder(unsigned start, unsigned end) noexcept {
+		for (unsigned i = start; i < end; ++i)
+			inverse_order[order[i]] = i;
+	}
+
+	/**
+	 * Record a modification in the #change_log.
+	 */
+	void LogChange(unsigned id) noexcept;
+
+	/**
+	 * Mark the item as "modified" in the current version.
+	 */
+	void Modify(Item &item) noexcept {
+		item.version = version;
+		LogChange(item.id);
+	}
+
 	void MoveItemTo(unsigned from, unsigned to) noexcept {
 		unsigned from_id = items[from].id;
 
 		items[to] = items[from];
-		items[to].version = version;
+		Modify(items[to]);
 		id_table.Move(from_id, to);
 	}
 
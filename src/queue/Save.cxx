@@ -7,6 +7,7 @@
 #include "song/DetachedSong.hxx"
 #include "SongSave.hxx"
 #include "playlist/PlaylistSong.hxx"
+#include "SongLoader.hxx"
 #include "io/LineReader.hxx"
 #include "io/BufferedOutputStream.hxx"
 #include "util/StringCompare.hxx"
@@ -80,12 +81,9 @@ LoadQueueSong(LineReader &file, const char *line)
 }
 
 void
-queue_load_song(LineReader &file, const SongLoader &loader,
-		const char *line, Queue &queue)
+queue_load_song(LineReader &file, const char *line,
+		std::vector<SavedQueueSong> &dest)
 {
-	if (queue.IsFull())
-		return;
-
 	uint8_t priority = 0;
 	const char *p;
 	if ((p = StringAfterPrefix(line, PRIO_LABEL))) {
@@ -97,9 +95,27 @@ queue_load_song(LineReader &file, const SongLoader &loader,
 	}
 
 	auto song = LoadQueueSong(file, line);
+	playlist_translate_song_uri(song, {});
+	dest.push_back({std::move(song), priority});
+}
 
-	if (!playlist_check_translate_song(song, {}, loader))
-		return;
+void
+queue_load_songs(const SongLoader &loader,
+		 std::vector<SavedQueueSong> &&songs, Queue &queue) noexcept
+{
+	std::vector<const char *> uris;
+	uris.reserve(songs.size());
+	for (const auto &i : songs)
+		uris.push_back(i.song.GetURI());
 
-	queue.Append(std::move(song), priority);
+	const auto loaded = loader.LoadSongs(uris);
+
+	for (std::size_t i = 0; i < songs.size() && !queue.IsFull(); ++i) {
+		if (!loaded[i])
+			continue;
+
+		auto &song = songs[i].song;
+		playlist_merge_loaded_song(song, *loaded[i]);
+		queue.Append(std::move(song), songs[i].priority);
+	}
 }
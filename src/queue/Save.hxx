@@ -8,19 +8,44 @@
 
 #pragma once
 
+#include "song/DetachedSong.hxx"
+
+#include <cstdint>
+#include <vector>
+
 struct Queue;
 class BufferedOutputStream;
 class LineReader;
 class SongLoader;
 
+/**
+ * A song which was parsed from the state file, but which has not
+ * been verified by the #SongLoader yet.
+ */
+struct SavedQueueSong {
+	DetachedSong song;
+	uint8_t priority;
+};
+
 void
 queue_save(BufferedOutputStream &os, const Queue &queue);
 
 /**
- * Loads one song from the state file and appends it to the queue.
+ * Parses one song from the state file and appends it to the given
+ * list.  Call queue_load_songs() to verify the songs and to add
+ * them to the queue.
  *
  * Throws on error.
  */
 void
-queue_load_song(LineReader &file, const SongLoader &loader,
-		const char *line, Queue &queue);
+queue_load_song(LineReader &file, const char *line,
+		std::vector<SavedQueueSong> &dest);
+
+/**
+ * Verify the songs which were parsed by queue_load_song() (with
+ * one SongLoader::LoadSongs() call for all of them) and append
+ * them to the queue.  Songs which cannot be loaded are skipped.
+ */
+void
+queue_load_songs(const SongLoader &loader,
+		 std::vector<SavedQueueSong> &&songs, Queue &queue) noexcept;
@@ -16,6 +16,7 @@ class AndSongFilter final : public ISongFilter {
 
 	friend void OptimizeSongFilter(AndSongFilter &) noexcept;
 	friend ISongFilterPtr OptimizeSongFilter(ISongFilterPtr) noexcept;
+	friend void ReorderSongFilter(ISongFilter &) noexcept;
 
 public:
 	const auto &GetItems() const noexcept {
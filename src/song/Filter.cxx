@@ -11,6 +11,11 @@
 #include "AddedSinceSongFilter.hxx"
 #include "AudioFormatSongFilter.hxx"
 #include "PrioritySongFilter.hxx"
+#include "OptimizeFilter.hxx"
+
+#ifdef HAVE_PCRE
+#include "RegexCache.hxx"
+#endif
 #include "pcm/AudioParser.hxx"
 #include "tag/ParseName.hxx"
 #include "tag/Type.hxx"
@@ -297,8 +302,8 @@ ParseStringFilter(const char *&s, bool fold_case, bool strip_diacritics)
 			StringFilter::Position::FULL,
 			negated,
 		};
-		f.SetRegex(std::make_shared<UniqueRegex>(f.GetValue().c_str(),
-							 Pcre::CompileOptions{.caseless=fold_case}));
+		f.SetRegex(GetCachedRegex(f.GetValue().c_str(),
+					  Pcre::CompileOptions{.caseless=fold_case}));
 		return f;
 	}
 #endif
@@ -529,10 +534,17 @@ SongFilter::Parse(std::span<const char *const> args, bool fold_case, bool strip_
 	} while (!args.empty());
 }
 
+void
+SongFilter::Normalize() noexcept
+{
+	OptimizeSongFilter(and_filter);
+}
+
 void
 SongFilter::Optimize() noexcept
 {
 	OptimizeSongFilter(and_filter);
+	ReorderSongFilter(and_filter);
 }
 
 bool
@@ -569,6 +581,51 @@ SongFilter::GetBase() const noexcept
 	return nullptr;
 }
 
+/**
+ * Returns the prefix which all URIs matched by this #StringFilter
+ * begin with, or an empty string if it cannot be determined.
+ */
+[[gnu::pure]]
+static std::string_view
+GetUriPrefix(const StringFilter &f) noexcept
+{
+	if (f.IsNegated() || !f.IsPlain())
+		return {};
+
+	switch (f.GetPosition()) {
+	case StringFilter::Position::FULL:
+	case StringFilter::Position::PREFIX:
+		return f.GetValue();
+
+	case StringFilter::Position::ANYWHERE:
+		break;
+	}
+
+	return {};
+}
+
+std::string_view
+SongFilter::GetUriPrefix() const noexcept
+{
+	std::string_view result;
+
+	for (const auto &i : and_filter.GetItems()) {
+		std::string_view prefix;
+
+		if (const auto *b = dynamic_cast<const BaseSongFilter *>(i.get()))
+			prefix = b->GetValue();
+		else if (const auto *u = dynamic_cast<const UriSongFilter *>(i.get()))
+			prefix = ::GetUriPrefix(u->GetStringFilter());
+
+		/* all items must match, so the longest prefix is
+		   the most specific one */
+		if (prefix.size() > result.size())
+			result = prefix;
+	}
+
+	return result;
+}
+
 SongFilter
 SongFilter::WithoutBasePrefix(const std::string_view prefix) const noexcept
 {
@@ -59,6 +59,17 @@ public:
 	 */
 	void Parse(std::span<const char *const> args, bool fold_case=false, bool strip_diacritics=false);
 
+	/**
+	 * Simplify the filter structure without changing the order
+	 * of its items.  Use this if the result of ToExpression() is
+	 * used as a key.
+	 */
+	void Normalize() noexcept;
+
+	/**
+	 * Like Normalize(), but additionally reorder the items so the
+	 * cheapest and most selective ones are evaluated first.
+	 */
 	void Optimize() noexcept;
 
 	[[gnu::pure]]
@@ -86,6 +97,16 @@ public:
 	[[gnu::pure]]
 	const char *GetBase() const noexcept;
 
+	/**
+	 * Returns a string which is a prefix of the URI of all
+	 * matching songs (or an empty string if there is no such
+	 * constraint).  This is derived from "base" items and from
+	 * case-sensitive "file" items.  It allows database walkers
+	 * to skip directories which cannot contain matching songs.
+	 */
+	[[gnu::pure]]
+	std::string_view GetUriPrefix() const noexcept;
+
 	/**
 	 * Create a copy of the filter with the given prefix stripped
 	 * from all #LOCATE_TAG_BASE_TYPE items.  This is used to
@@ -13,12 +13,17 @@ class NotSongFilter final : public ISongFilter {
 	ISongFilterPtr child;
 
 	friend ISongFilterPtr OptimizeSongFilter(ISongFilterPtr) noexcept;
+	friend void ReorderSongFilter(ISongFilter &) noexcept;
 
 public:
 	template<typename C>
 	explicit NotSongFilter(C &&_child) noexcept
 		:child(std::forward<C>(_child)) {}
 
+	const ISongFilter &GetChild() const noexcept {
+		return *child;
+	}
+
 	/* virtual methods from ISongFilter */
 	ISongFilterPtr Clone() const noexcept override {
 		return std::make_unique<NotSongFilter>(child->Clone());
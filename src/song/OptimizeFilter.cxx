@@ -4,8 +4,10 @@
 #include "OptimizeFilter.hxx"
 #include "AndSongFilter.hxx"
 #include "NotSongFilter.hxx"
+#include "BaseSongFilter.hxx"
 #include "TagSongFilter.hxx"
 #include "UriSongFilter.hxx"
+#include "tag/Type.hxx"
 
 void
 OptimizeSongFilter(AndSongFilter &af) noexcept
@@ -54,3 +56,58 @@ OptimizeSongFilter(ISongFilterPtr f) noexcept
 
 	return f;
 }
+
+/**
+ * Estimate the relative cost of evaluating the given filter.  The
+ * numbers are arbitrary; only their order matters.
+ */
+[[gnu::pure]]
+static unsigned
+EstimateCost(const ISongFilter &f) noexcept
+{
+	if (dynamic_cast<const BaseSongFilter *>(&f) != nullptr)
+		/* a cheap prefix comparison which usually rules out
+		   most songs */
+		return 1;
+
+	if (const auto *uf = dynamic_cast<const UriSongFilter *>(&f))
+		return 2 + uf->GetStringFilter().GetCost();
+
+	if (const auto *tf = dynamic_cast<const TagSongFilter *>(&f)) {
+		/* "any" compares the value of every tag item */
+		const unsigned scan = tf->GetTagType() == TAG_NUM_OF_ITEM_TYPES
+			? 16 : 4;
+		return scan * tf->GetStringFilter().GetCost();
+	}
+
+	if (const auto *af = dynamic_cast<const AndSongFilter *>(&f)) {
+		unsigned cost = 0;
+		for (const auto &i : af->GetItems())
+			cost += EstimateCost(*i);
+		return cost;
+	}
+
+	if (const auto *nf = dynamic_cast<const NotSongFilter *>(&f))
+		return EstimateCost(nf->GetChild());
+
+	/* all other filters (modified-since, AudioFormat, prio,
+	   ...) compare a few integers */
+	return 2;
+}
+
+void
+ReorderSongFilter(ISongFilter &f) noexcept
+{
+	if (auto *af = dynamic_cast<AndSongFilter *>(&f)) {
+		for (auto &i : af->items)
+			ReorderSongFilter(*i);
+
+		/* std::list::sort() is stable, so items with the
+		   same cost retain their original order */
+		af->items.sort([](const auto &a, const auto &b){
+			return EstimateCost(*a) < EstimateCost(*b);
+		});
+	} else if (auto *nf = dynamic_cast<NotSongFilter *>(&f)) {
+		ReorderSongFilter(*nf->child);
+	}
+}
@@ -14,4 +14,18 @@ OptimizeSongFilter(AndSongFilter &af) noexcept;
 ISongFilterPtr
 OptimizeSongFilter(ISongFilterPtr f) noexcept;
 
+/**
+ * Reorder the items of all (nested) #AndSongFilter instances by
+ * their estimated cost and selectivity, so AndSongFilter::Match()
+ * evaluates cheap and selective items (e.g. "base") first and can
+ * bail out before evaluating the expensive ones (e.g. "contains"
+ * or regular expressions).
+ *
+ * This changes the result of ToExpression(), therefore it must not
+ * be applied to filters whose expression is used as a persistent
+ * key.
+ */
+void
+ReorderSongFilter(ISongFilter &f) noexcept;
+
 #endif
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "RegexCache.hxx"
+#include "thread/Mutex.hxx"
+#include "util/LRUCache.hxx"
+
+#include <functional> // for std::hash
+#include <string>
+#include <string_view>
+
+/**
+ * The maximum number of compiled patterns kept in the cache.
+ */
+static constexpr std::size_t MAX_ITEMS = 64;
+
+namespace {
+
+struct RegexCacheKey {
+	std::string_view pattern;
+	int options;
+
+	friend constexpr bool operator==(const RegexCacheKey &,
+					 const RegexCacheKey &) noexcept = default;
+
+	struct Hash {
+		[[gnu::pure]]
+		std::size_t operator()(const RegexCacheKey &key) const noexcept {
+			return std::hash<std::string_view>{}(key.pattern) ^ key.options;
+		}
+	};
+};
+
+/**
+ * The key as stored in the cache; it owns a copy of the pattern.
+ */
+struct StoredRegexCacheKey {
+	std::string pattern;
+	int options;
+
+	operator RegexCacheKey() const noexcept {
+		return {pattern, options};
+	}
+};
+
+class RegexCache {
+	Mutex mutex;
+
+	/**
+	 * Each item has the size 1, which limits the number of
+	 * items.
+	 */
+	LRUCache<StoredRegexCacheKey, std::shared_ptr<const UniqueRegex>,
+		 RegexCacheKey::Hash,
+		 std::equal_to<RegexCacheKey>> cache{MAX_ITEMS};
+
+public:
+	std::shared_ptr<const UniqueRegex> Get(const char *pattern,
+					       int options);
+
+private:
+	std::shared_ptr<const UniqueRegex> Find(const RegexCacheKey &key) noexcept {
+		if (const auto *regex = cache.Get(key))
+			return *regex;
+		return {};
+	}
+};
+
+std::shared_ptr<const UniqueRegex>
+RegexCache::Get(const char *pattern, int options)
+{
+	const RegexCacheKey key{pattern, options};
+
+	{
+		const std::scoped_lock lock{mutex};
+		if (auto regex = Find(key))
+			return regex;
+	}
+
+	/* compile outside of the lock; this may throw */
+	auto regex = std::make_shared<UniqueRegex>();
+	regex->Compile(pattern, options);
+
+	const std::scoped_lock lock{mutex};
+
+	/* another thread may have compiled the same pattern
+	   meanwhile */
+	if (auto existing = Find(key))
+		return existing;
+
+	std::shared_ptr<const UniqueRegex> result = std::move(regex);
+	cache.Put({std::string{key.pattern}, options},
+		  std::shared_ptr<const UniqueRegex>{result}, 1);
+	return result;
+}
+
+RegexCache regex_cache;
+
+} // anonymous namespace
+
+std::shared_ptr<const UniqueRegex>
+GetCachedRegex(const char *pattern, Pcre::CompileOptions options)
+{
+	return regex_cache.Get(pattern, int(options));
+}
@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "lib/pcre/UniqueRegex.hxx"
+
+#include <memory>
+
+/**
+ * Look up a compiled regular expression in a process-wide LRU cache,
+ * or compile it and add it to the cache.  This allows clients which
+ * repeat the same "=~" filter to skip compilation entirely.  The
+ * returned object is immutable and may be shared by many
+ * #StringFilter instances.
+ *
+ * This function is thread-safe.
+ *
+ * Throws on error.
+ */
+std::shared_ptr<const UniqueRegex>
+GetCachedRegex(const char *pattern, Pcre::CompileOptions options);
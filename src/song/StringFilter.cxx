@@ -6,6 +6,21 @@
 
 #include <cassert>
 
+unsigned
+StringFilter::GetCost() const noexcept
+{
+	if (IsRegex())
+		return 32;
+
+	unsigned cost = position == Position::ANYWHERE ? 3 : 1;
+	if (icu_compare)
+		/* case folding and diacritics stripping need to
+		   convert each haystack */
+		cost *= 4;
+
+	return cost;
+}
+
 bool
 StringFilter::MatchWithoutNegation(const char *s) const noexcept
 {
@@ -13,7 +28,7 @@ StringFilter::MatchWithoutNegation(const char *s) const noexcept
 
 #ifdef HAVE_PCRE
 	if (regex)
-		return regex->Match(s);
+		return regex->Test(s);
 #endif
 
 	if (icu_compare) {
@@ -37,7 +37,7 @@ private:
 	IcuCompare icu_compare;
 
 #ifdef HAVE_PCRE
-	std::shared_ptr<UniqueRegex> regex;
+	std::shared_ptr<const UniqueRegex> regex;
 #endif
 
 	Position position;
@@ -77,6 +77,18 @@ public:
 		return value;
 	}
 
+	Position GetPosition() const noexcept {
+		return position;
+	}
+
+	/**
+	 * Is this a plain byte-wise comparison, i.e. no regular
+	 * expression, no case folding and no diacritics stripping?
+	 */
+	bool IsPlain() const noexcept {
+		return !IsRegex() && !icu_compare;
+	}
+
 	bool GetFoldCase() const noexcept {
 		return icu_compare.GetFoldCase();
 	}
@@ -107,6 +119,13 @@ public:
 		return negated ? "!=" : "==";
 	}
 
+	/**
+	 * Estimate the relative CPU cost of one MatchWithoutNegation()
+	 * call.  This is a heuristic used by ReorderSongFilter().
+	 */
+	[[gnu::pure]]
+	unsigned GetCost() const noexcept;
+
 	[[gnu::pure]]
 	bool Match(const char *s) const noexcept;
 
@@ -18,6 +18,10 @@ public:
 		return filter.GetValue();
 	}
 
+	const StringFilter &GetStringFilter() const noexcept {
+		return filter;
+	}
+
 	bool GetFoldCase() const {
 		return filter.GetFoldCase();
 	}
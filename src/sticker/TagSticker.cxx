@@ -19,7 +19,7 @@ MakeSongFilter(const char *filter_string)
 
 	auto filter = SongFilter();
 	filter.Parse(args, false);
-	filter.Optimize();
+	filter.Normalize();
 
 	return filter;
 }
@@ -34,7 +34,7 @@ MakeSongFilter(TagType tag_type, const char *tag_value)
 
 	SongFilter filter;
 	filter.Parse(args, false);
-	filter.Optimize();
+	filter.Normalize();
 	return filter;
 }
 
@@ -30,15 +30,9 @@ TagBuilder::TagBuilder(Tag &&other) noexcept
 	:duration(other.duration), has_playlist(other.has_playlist)
 {
 	/* move all TagItem pointers from the Tag object; we don't
-	   need to contact the tag pool, because all we do is move
-	   references */
-	items.reserve(other.num_items);
-	std::copy_n(other.items, other.num_items, std::back_inserter(items));
-
-	/* discard the pointers from the Tag object */
-	other.num_items = 0;
-	delete[] other.items;
-	other.items = nullptr;
+	   need to contact the tag pool unless the Tag shares its
+	   array with others */
+	other.MoveItemsTo(items);
 }
 
 TagBuilder &
@@ -84,16 +78,10 @@ TagBuilder::operator=(Tag &&other) noexcept
 	has_playlist = other.has_playlist;
 
 	/* move all TagItem pointers from the Tag object; we don't
-	   need to contact the tag pool, because all we do is move
-	   references */
+	   need to contact the tag pool unless the Tag shares its
+	   array with others */
 	RemoveAll();
-	items.reserve(other.num_items);
-	std::copy_n(other.items, other.num_items, std::back_inserter(items));
-
-	/* discard the pointers from the Tag object */
-	other.num_items = 0;
-	delete[] other.items;
-	other.items = nullptr;
+	other.MoveItemsTo(items);
 
 	return *this;
 }
@@ -118,10 +106,7 @@ TagBuilder::Commit(Tag &tag) noexcept
 	   touching the TagPool reference counters; the
 	   vector::clear() call is important to detach them from this
 	   object */
-	const unsigned n_items = items.size();
-	tag.num_items = n_items;
-	tag.items = new TagItem *[n_items];
-	std::copy_n(items.begin(), n_items, tag.items);
+	tag.AdoptItems(items);
 	items.clear();
 
 	/* now ensure that this object is fresh (will not delete any
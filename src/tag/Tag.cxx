@@ -5,7 +5,37 @@
 #include "Pool.hxx"
 #include "Builder.hxx"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <new>
+
+/**
+ * The header of a #Tag::items allocation.  It is followed by the
+ * #TagItem pointers.
+ */
+struct alignas(TagItem *) TagItemArrayHeader {
+	std::atomic_uint ref{1};
+
+	TagItem **GetItems() noexcept {
+		return reinterpret_cast<TagItem **>(this + 1);
+	}
+
+	static TagItemArrayHeader &Of(TagItem *const*items) noexcept {
+		return *(reinterpret_cast<TagItemArrayHeader *>(const_cast<TagItem **>(items)) - 1);
+	}
+
+	static TagItemArrayHeader *New(std::size_t n) noexcept {
+		void *p = ::operator new(sizeof(TagItemArrayHeader) +
+					 n * sizeof(TagItem *));
+		return ::new(p) TagItemArrayHeader();
+	}
+
+	void Free() noexcept {
+		this->~TagItemArrayHeader();
+		::operator delete(this);
+	}
+};
 
 bool
 Tag::operator==(const Tag &other) const noexcept {
@@ -22,28 +52,80 @@ Tag::Clear() noexcept
 	duration = SignedSongTime::Negative();
 	has_playlist = false;
 
-	if (num_items > 0) {
-		assert(items != nullptr);
-		const std::scoped_lock protect{tag_pool_lock};
-		for (unsigned i = 0; i < num_items; ++i)
-			tag_pool_put_item(items[i]);
+	ReleaseItems();
+}
+
+void
+Tag::ReleaseItems() noexcept
+{
+	if (items != nullptr) {
+		assert(num_items > 0);
+
+		auto &header = TagItemArrayHeader::Of(items);
+		if (header.ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			/* this was the last reference to the array */
+			{
+				const std::scoped_lock protect{tag_pool_lock};
+				for (unsigned i = 0; i < num_items; ++i)
+					tag_pool_put_item(items[i]);
+			}
+
+			header.Free();
+		}
+
+		items = nullptr;
 		num_items = 0;
 	}
-
-	delete[] items;
-	items = nullptr;
 }
 
 Tag::Tag(const Tag &other) noexcept
 	:duration(other.duration), has_playlist(other.has_playlist),
-	 num_items(other.num_items)
+	 num_items(other.num_items), items(other.items)
 {
-	if (num_items > 0) {
-		items = new TagItem *[num_items];
+	if (items != nullptr)
+		TagItemArrayHeader::Of(items).ref.fetch_add(1, std::memory_order_relaxed);
+}
 
-		const std::scoped_lock protect{tag_pool_lock};
-		for (unsigned i = 0; i < num_items; i++)
-			items[i] = tag_pool_dup_item(other.items[i]);
+void
+Tag::AdoptItems(std::span<TagItem *const> src) noexcept
+{
+	assert(items == nullptr);
+	assert(num_items == 0);
+
+	if (src.empty())
+		return;
+
+	auto *header = TagItemArrayHeader::New(src.size());
+	std::copy(src.begin(), src.end(), header->GetItems());
+	items = header->GetItems();
+	num_items = src.size();
+}
+
+void
+Tag::MoveItemsTo(std::vector<TagItem *> &dest) noexcept
+{
+	if (items == nullptr)
+		return;
+
+	dest.insert(dest.end(), items, items + num_items);
+
+	auto &header = TagItemArrayHeader::Of(items);
+	if (header.ref.load(std::memory_order_acquire) == 1) {
+		/* we're the only owner; move the references without
+		   contacting the tag pool */
+		header.Free();
+		items = nullptr;
+		num_items = 0;
+	} else {
+		/* the array is shared with other Tag instances, so
+		   the caller needs its own references */
+		{
+			const std::scoped_lock protect{tag_pool_lock};
+			for (auto i = dest.end() - num_items; i != dest.end(); ++i)
+				*i = tag_pool_dup_item(*i);
+		}
+
+		ReleaseItems();
 	}
 }
 
@@ -10,7 +10,9 @@
 #include "util/DereferenceIterator.hxx"
 
 #include <memory>
+#include <span>
 #include <utility>
+#include <vector>
 
 /**
  * The meta information about a song file.  It is a MPD specific
@@ -32,14 +34,22 @@ struct Tag {
 	/** the total number of tag items in the #items array */
 	unsigned short num_items = 0;
 
-	/** an array of tag items */
-	TagItem **items = nullptr;
+	/**
+	 * An array of tag items.  It is reference counted and may be
+	 * shared with other #Tag instances (which makes copying a
+	 * #Tag cheap), and therefore it must never be modified.
+	 */
+	TagItem *const*items = nullptr;
 
 	/**
 	 * Create an empty tag.
 	 */
 	Tag() = default;
 
+	/**
+	 * Copy a tag.  This does not duplicate the #items array, it
+	 * only increments its reference counter.
+	 */
 	Tag(const Tag &other) noexcept;
 
 	Tag(Tag &&other) noexcept
@@ -76,6 +86,21 @@ struct Tag {
 		std::swap(num_items, other.num_items);
 	}
 
+	/**
+	 * Allocate a new #items array containing the given items.
+	 * This object adopts the tag pool references of these items.
+	 * It must not have an #items array yet.
+	 */
+	void AdoptItems(std::span<TagItem *const> src) noexcept;
+
+	/**
+	 * Move all tag pool references of the #items array to the
+	 * given vector and clear this object's #items array.  If the
+	 * array is shared with other #Tag instances, new references
+	 * are obtained instead.
+	 */
+	void MoveItemsTo(std::vector<TagItem *> &dest) noexcept;
+
 	/**
 	 * Returns true if the tag contains no items.  This ignores
 	 * the "duration" attribute.
@@ -159,6 +184,13 @@ struct Tag {
 	const_iterator end() const noexcept {
 		return const_iterator{items + num_items};
 	}
+
+private:
+	/**
+	 * Release this object's reference to the #items array (and
+	 * the tag pool references if it was the last one).
+	 */
+	void ReleaseItems() noexcept;
 };
 
 #endif
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include "DeleteDisposer.hxx"
+#include "IntrusiveHashSet.hxx"
+#include "IntrusiveList.hxx"
+
+#include <cassert>
+#include <cstddef>
+#include <functional> // for std::hash, std::equal_to
+#include <utility> // for std::move()
+
+/**
+ * A cache which maps keys to values and evicts the least recently
+ * used items when the total size of all items exceeds a limit.  The
+ * "size" of an item is chosen by the caller; it may be the number of
+ * bytes occupied by the item or just 1 to limit the number of items.
+ *
+ * Lookups may use any key type which is accepted by #Hash and
+ * #Equal, e.g. a std::string_view for a std::string key.
+ *
+ * This class is not thread-safe.
+ */
+template<typename Key, typename Value,
+	 typename Hash=std::hash<Key>, typename Equal=std::equal_to<Key>,
+	 std::size_t table_size=127>
+class LRUCache {
+	struct Item final
+		: IntrusiveListHook<>,
+		  IntrusiveHashSetHook<>
+	{
+		const Key key;
+		Value value;
+		const std::size_t size;
+
+		Item(Key &&_key, Value &&_value, std::size_t _size) noexcept
+			:key(std::move(_key)), value(std::move(_value)),
+			 size(_size) {}
+
+		struct GetKey {
+			[[gnu::pure]]
+			const Key &operator()(const Item &item) const noexcept {
+				return item.key;
+			}
+		};
+	};
+
+	const std::size_t max_size;
+
+	std::size_t size = 0;
+
+	/**
+	 * All items, the least recently used one first.
+	 */
+	IntrusiveList<Item> items_by_time;
+
+	IntrusiveHashSet<Item, table_size,
+			 IntrusiveHashSetOperators<Item, typename Item::GetKey,
+						   Hash, Equal>> items_by_key;
+
+public:
+	explicit LRUCache(std::size_t _max_size) noexcept
+		:max_size(_max_size) {}
+
+	~LRUCache() noexcept {
+		Clear();
+	}
+
+	LRUCache(const LRUCache &) = delete;
+	LRUCache &operator=(const LRUCache &) = delete;
+
+	std::size_t GetMaxSize() const noexcept {
+		return max_size;
+	}
+
+	/**
+	 * The sum of the sizes of all items.
+	 */
+	std::size_t GetSize() const noexcept {
+		return size;
+	}
+
+	/**
+	 * Look up an item and mark it as the most recently used one.
+	 *
+	 * @return the value or nullptr if there is no such item; the
+	 * pointer is valid until the item is removed
+	 */
+	Value *Get(const auto &key) noexcept {
+		auto i = items_by_key.find(key);
+		if (i == items_by_key.end())
+			return nullptr;
+
+		/* refresh */
+		auto &item = *i;
+		items_by_time.erase(items_by_time.iterator_to(item));
+		items_by_time.push_back(item);
+
+		return &item.value;
+	}
+
+	/**
+	 * Add an item, replacing an existing item with the same key.
+	 * Least recently used items are evicted to make room for it.
+	 *
+	 * @param item_size the size of the new item (see class
+	 * documentation)
+	 * @return the stored value or nullptr if the item is larger
+	 * than the whole cache; the pointer is valid until the item
+	 * is removed
+	 */
+	Value *Put(Key &&key, Value &&value, std::size_t item_size) noexcept {
+		if (item_size > max_size)
+			return nullptr;
+
+		Remove(key);
+
+		while (size + item_size > max_size) {
+			assert(!items_by_time.empty());
+			Delete(items_by_time.front());
+		}
+
+		auto *item = new Item(std::move(key), std::move(value),
+				      item_size);
+		size += item_size;
+		items_by_key.insert(*item);
+		items_by_time.push_back(*item);
+		return &item->value;
+	}
+
+	/**
+	 * Remove the item with the given key (if it exists).
+	 */
+	void Remove(const auto &key) noexcept {
+		if (auto i = items_by_key.find(key); i != items_by_key.end())
+			Delete(*i);
+	}
+
+	/**
+	 * Remove all items.
+	 */
+	void Clear() noexcept {
+		items_by_key.clear();
+		items_by_time.clear_and_dispose(DeleteDisposer{});
+		size = 0;
+	}
+
+private:
+	void Delete(Item &item) noexcept {
+		assert(size >= item.size);
+		size -= item.size;
+
+		items_by_key.erase(items_by_key.iterator_to(item));
+		items_by_time.erase(items_by_time.iterator_to(item));
+		delete &item;
+	}
+};
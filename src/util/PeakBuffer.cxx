@@ -20,6 +20,17 @@ PeakBuffer::empty() const noexcept
 		(peak_buffer == nullptr || peak_buffer->empty());
 }
 
+std::size_t
+PeakBuffer::size() const noexcept
+{
+	std::size_t result = 0;
+	if (normal_buffer != nullptr)
+		result += normal_buffer->GetAvailable();
+	if (peak_buffer != nullptr)
+		result += peak_buffer->GetAvailable();
+	return result;
+}
+
 std::span<std::byte>
 PeakBuffer::Read() const noexcept
 {
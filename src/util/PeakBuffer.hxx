@@ -44,6 +44,12 @@ public:
 	[[gnu::pure]]
 	bool empty() const noexcept;
 
+	/**
+	 * @return the number of bytes which can be read
+	 */
+	[[gnu::pure]]
+	std::size_t size() const noexcept;
+
 	[[gnu::pure]]
 	std::span<std::byte> Read() const noexcept;
 
@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "StringSearch.hxx"
+#include "CharUtil.hxx"
+
+#include <bit>
+#include <cstring>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+template<bool fold_case>
+[[gnu::always_inline]]
+static inline bool
+EqualMiddle(const char *a, const char *b, std::size_t size) noexcept
+{
+	if constexpr (fold_case) {
+		for (std::size_t i = 0; i < size; ++i)
+			if (ToLowerASCII(a[i]) != b[i])
+				return false;
+		return true;
+	} else
+		return std::memcmp(a, b, size) == 0;
+}
+
+/**
+ * The portable implementation, also used for the tail of the
+ * haystack which is too short for a vector load.
+ */
+template<bool fold_case>
+static const char *
+SearchScalar(const char *haystack, std::size_t haystack_size,
+	     std::string_view needle) noexcept
+{
+	if constexpr (!fold_case) {
+		const auto i = std::string_view{haystack, haystack_size}.find(needle);
+		return i != std::string_view::npos
+			? haystack + i
+			: nullptr;
+	} else {
+		if (haystack_size < needle.size())
+			return nullptr;
+
+		const char *const end = haystack + haystack_size - needle.size();
+		for (const char *p = haystack; p <= end; ++p)
+			if (ToLowerASCII(*p) == needle.front() &&
+			    EqualMiddle<true>(p + 1, needle.data() + 1,
+					      needle.size() - 1))
+				return p;
+
+		return nullptr;
+	}
+}
+
+#ifdef __x86_64__
+
+/**
+ * Verify the candidate positions found by the vector comparison.
+ *
+ * @param mask a bit mask of candidate positions relative to #offset
+ */
+template<bool fold_case>
+[[gnu::always_inline]]
+static inline const char *
+CheckCandidates(const char *haystack, std::size_t offset, unsigned mask,
+		std::string_view needle) noexcept
+{
+	const std::size_t middle_size = needle.size() >= 2 ? needle.size() - 2 : 0;
+
+	while (mask != 0) {
+		const char *p = haystack + offset + std::countr_zero(mask);
+		if (EqualMiddle<fold_case>(p + 1, needle.data() + 1,
+					   middle_size))
+			return p;
+
+		mask &= mask - 1;
+	}
+
+	return nullptr;
+}
+
+/**
+ * Convert all ASCII upper case letters in the vector to lower case.
+ */
+static inline __m128i
+ToLowerSSE2(__m128i v) noexcept
+{
+	/* signed comparisons: bytes >= 0x80 are negative and thus
+	   never considered upper case */
+	const __m128i upper =
+		_mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+			      _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+	return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+/**
+ * Compare the first and the last needle byte with 16 haystack
+ * positions.
+ *
+ * @return a bit mask of candidate positions
+ */
+template<bool fold_case>
+[[gnu::always_inline]]
+static inline unsigned
+BlockSSE2(const char *p, std::size_t last_offset,
+	  __m128i first, __m128i last) noexcept
+{
+	__m128i block_first = _mm_loadu_si128((const __m128i *)p);
+	__m128i block_last = _mm_loadu_si128((const __m128i *)(p + last_offset));
+	if constexpr (fold_case) {
+		block_first = ToLowerSSE2(block_first);
+		block_last = ToLowerSSE2(block_last);
+	}
+
+	return _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+					       _mm_cmpeq_epi8(last, block_last)));
+}
+
+/**
+ * SSE2 is part of the x86-64 baseline, so this implementation is
+ * always available.
+ *
+ * @param i the first haystack position to be checked; all previous
+ * positions have already been checked by the caller
+ */
+template<bool fold_case>
+static const char *
+SearchSSE2(const char *haystack, std::size_t haystack_size,
+	   std::string_view needle, std::size_t i=0) noexcept
+{
+	constexpr std::size_t VECTOR_SIZE = sizeof(__m128i);
+	const std::size_t last_offset = needle.size() - 1;
+
+	if (haystack_size < last_offset + VECTOR_SIZE)
+		return SearchScalar<fold_case>(haystack + i, haystack_size - i,
+					       needle);
+
+	const __m128i first = _mm_set1_epi8(needle.front());
+	const __m128i last = _mm_set1_epi8(needle.back());
+
+	for (; i + last_offset + VECTOR_SIZE <= haystack_size; i += VECTOR_SIZE) {
+		const unsigned mask = BlockSSE2<fold_case>(haystack + i, last_offset,
+							   first, last);
+		if (const char *p = CheckCandidates<fold_case>(haystack, i, mask, needle))
+			return p;
+	}
+
+	if (i + last_offset >= haystack_size)
+		return nullptr;
+
+	/* check the remaining positions with one last block which
+	   overlaps with the previous one, discarding the positions
+	   which have already been checked */
+	const std::size_t j = haystack_size - last_offset - VECTOR_SIZE;
+	const unsigned mask = BlockSSE2<fold_case>(haystack + j, last_offset,
+						   first, last)
+		& (~0U << (i - j));
+	return CheckCandidates<fold_case>(haystack, j, mask, needle);
+}
+
+[[gnu::target("avx2")]]
+static inline __m256i
+ToLowerAVX2(__m256i v) noexcept
+{
+	const __m256i upper =
+		_mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+				 _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+	return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+template<bool fold_case>
+[[gnu::target("avx2")]] [[gnu::always_inline]]
+static inline unsigned
+BlockAVX2(const char *p, std::size_t last_offset,
+	  __m256i first, __m256i last) noexcept
+{
+	__m256i block_first = _mm256_loadu_si256((const __m256i *)p);
+	__m256i block_last = _mm256_loadu_si256((const __m256i *)(p + last_offset));
+	if constexpr (fold_case) {
+		block_first = ToLowerAVX2(block_first);
+		block_last = ToLowerAVX2(block_last);
+	}
+
+	return _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+						     _mm256_cmpeq_epi8(last, block_last)));
+}
+
+template<bool fold_case>
+[[gnu::target("avx2")]]
+static const char *
+SearchAVX2(const char *haystack, std::size_t haystack_size,
+	   std::string_view needle) noexcept
+{
+	constexpr std::size_t VECTOR_SIZE = sizeof(__m256i);
+	const std::size_t last_offset = needle.size() - 1;
+
+	if (haystack_size < last_offset + VECTOR_SIZE)
+		/* too short for one AVX2 block */
+		return SearchSSE2<fold_case>(haystack, haystack_size, needle);
+
+	const __m256i first = _mm256_set1_epi8(needle.front());
+	const __m256i last = _mm256_set1_epi8(needle.back());
+
+	std::size_t i = 0;
+	for (; i + last_offset + VECTOR_SIZE <= haystack_size; i += VECTOR_SIZE) {
+		const unsigned mask = BlockAVX2<fold_case>(haystack + i, last_offset,
+							   first, last);
+		if (const char *p = CheckCandidates<fold_case>(haystack, i, mask, needle))
+			return p;
+	}
+
+	if (i + last_offset >= haystack_size)
+		return nullptr;
+
+	const std::size_t j = haystack_size - last_offset - VECTOR_SIZE;
+	const unsigned mask = BlockAVX2<fold_case>(haystack + j, last_offset,
+						   first, last)
+		& (~0U << (i - j));
+	return CheckCandidates<fold_case>(haystack, j, mask, needle);
+}
+
+static bool
+HaveAVX2() noexcept
+{
+	static const bool value = __builtin_cpu_supports("avx2");
+	return value;
+}
+
+#endif // __x86_64__
+
+template<bool fold_case>
+static const char *
+Search(std::string_view haystack, std::string_view needle) noexcept
+{
+	if (needle.empty())
+		return haystack.data();
+
+	if (haystack.size() < needle.size())
+		return nullptr;
+
+#ifdef __x86_64__
+	if (HaveAVX2())
+		return SearchAVX2<fold_case>(haystack.data(), haystack.size(),
+					     needle);
+
+	return SearchSSE2<fold_case>(haystack.data(), haystack.size(), needle);
+#else
+	return SearchScalar<fold_case>(haystack.data(), haystack.size(),
+				       needle);
+#endif
+}
+
+const char *
+StringSearch(std::string_view haystack, std::string_view needle) noexcept
+{
+	return Search<false>(haystack, needle);
+}
+
+const char *
+StringSearchIgnoreCaseASCII(std::string_view haystack,
+			    std::string_view lower_needle) noexcept
+{
+	return Search<true>(haystack, lower_needle);
+}
+
+bool
+StringIsASCII(std::string_view s) noexcept
+{
+	/* no early return: this loop is easy to vectorize */
+	unsigned char bits = 0;
+	for (const char ch : s)
+		bits |= static_cast<unsigned char>(ch);
+
+	return (bits & 0x80) == 0;
+}
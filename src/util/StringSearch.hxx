@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#pragma once
+
+#include <string_view>
+
+/**
+ * Find the first occurrence of #needle in #haystack (like memmem()).
+ *
+ * On x86-64, this compares the first and the last byte of the needle
+ * with 16 (SSE2) or 32 (AVX2, if supported by the CPU) haystack
+ * positions at once and verifies only the candidates.
+ *
+ * @return a pointer to the first match or nullptr if there is none
+ */
+[[gnu::pure]]
+const char *
+StringSearch(std::string_view haystack, std::string_view needle) noexcept;
+
+/**
+ * Like StringSearch(), but ignore the case of ASCII letters.
+ * Non-ASCII bytes are compared literally.
+ *
+ * @param lower_needle the needle; all ASCII letters must be lower
+ * case already
+ */
+[[gnu::pure]]
+const char *
+StringSearchIgnoreCaseASCII(std::string_view haystack,
+			    std::string_view lower_needle) noexcept;
+
+/**
+ * Does the string consist only of ASCII characters?
+ */
+[[gnu::pure]]
+bool
+StringIsASCII(std::string_view s) noexcept;
@@ -25,6 +25,7 @@ DumpDecoderClient::Ready(const AudioFormat audio_format,
 	fmt::print(stderr, "audio_format={} duration={} seekable={}\n",
 		   audio_format, duration.ToDoubleS(), seekable);
 
+	frame_size = audio_format.GetFrameSize();
 	initialized = true;
 }
 
@@ -93,6 +94,25 @@ DumpDecoderClient::SubmitAudio([[maybe_unused]] InputStream *is,
 	return GetCommand();
 }
 
+std::span<std::byte>
+DumpDecoderClient::GetAudioBuffer([[maybe_unused]] InputStream *is,
+				  uint16_t kbit_rate) noexcept
+{
+	assert(initialized);
+
+	const std::size_t size = 4096 / frame_size * frame_size;
+	pending_audio = {audio_buffer.GetT<std::byte>(size), size};
+	pending_kbit_rate = kbit_rate;
+	return pending_audio;
+}
+
+DecoderCommand
+DumpDecoderClient::CommitAudio(std::size_t nbytes) noexcept
+{
+	return SubmitAudio(nullptr, pending_audio.first(nbytes),
+			   pending_kbit_rate);
+}
+
 DecoderCommand
 DumpDecoderClient::SubmitTag([[maybe_unused]] InputStream *is,
 			     Tag &&tag) noexcept
@@ -5,6 +5,7 @@
 #define DUMP_DECODER_CLIENT_HXX
 
 #include "decoder/Client.hxx"
+#include "pcm/Buffer.hxx"
 #include "thread/Mutex.hxx"
 
 /**
@@ -16,6 +17,16 @@ class DumpDecoderClient : public DecoderClient {
 
 	uint16_t prev_kbit_rate = 0;
 
+	std::size_t frame_size;
+
+	/**
+	 * The buffer returned by GetAudioBuffer().
+	 */
+	PcmBuffer audio_buffer;
+
+	std::span<std::byte> pending_audio;
+	uint16_t pending_kbit_rate;
+
 public:
 	Mutex mutex;
 
@@ -38,6 +49,9 @@ public:
 	DecoderCommand SubmitAudio(InputStream *is,
 				   std::span<const std::byte> audio,
 				   uint16_t kbit_rate) noexcept override;
+	std::span<std::byte> GetAudioBuffer(InputStream *is,
+					    uint16_t kbit_rate) noexcept override;
+	DecoderCommand CommitAudio(std::size_t nbytes) noexcept override;
 	DecoderCommand SubmitTag(InputStream *is, Tag &&tag) noexcept override;
 	void SubmitReplayGain(const ReplayGainInfo *replay_gain_info) noexcept override;
 	void SubmitMixRamp(MixRampInfo &&mix_ramp) noexcept override;
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "command/CommandStats.hxx"
+
+#include <gtest/gtest.h>
+
+using std::chrono::microseconds;
+
+TEST(CommandStats, Counters)
+{
+	CommandStats stats;
+	EXPECT_EQ(stats.GetCalls(), 0U);
+	EXPECT_EQ(stats.GetPercentile(50), CommandStats::Duration{});
+
+	stats.Add(microseconds{10}, false, 100);
+	stats.Add(microseconds{30}, true, 50);
+
+	EXPECT_EQ(stats.GetCalls(), 2U);
+	EXPECT_EQ(stats.GetErrors(), 1U);
+	EXPECT_EQ(stats.GetBytes(), 150U);
+	EXPECT_EQ(stats.GetTotalDuration(), microseconds{40});
+	EXPECT_EQ(stats.GetMaxDuration(), microseconds{30});
+
+	stats.Reset();
+	EXPECT_EQ(stats.GetCalls(), 0U);
+	EXPECT_EQ(stats.GetTotalDuration(), CommandStats::Duration{});
+}
+
+TEST(CommandStats, Percentile)
+{
+	CommandStats stats;
+
+	/* 90 fast calls and 10 slow ones */
+	for (unsigned i = 0; i < 90; ++i)
+		stats.Add(microseconds{100}, false, 0);
+	for (unsigned i = 0; i < 10; ++i)
+		stats.Add(microseconds{100000}, false, 0);
+
+	/* 100us is in the bucket [64us, 128us) */
+	EXPECT_EQ(stats.GetPercentile(50), microseconds{128});
+	EXPECT_EQ(stats.GetPercentile(90), microseconds{128});
+
+	/* the percentile is clamped to the maximum */
+	EXPECT_EQ(stats.GetPercentile(99), microseconds{100000});
+	EXPECT_EQ(stats.GetPercentile(100), microseconds{100000});
+}
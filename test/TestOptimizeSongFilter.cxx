@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "song/Filter.hxx"
+#include "lib/icu/Init.hxx"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+class OptimizeSongFilterTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		IcuInit();
+	}
+
+	void TearDown() override {
+		IcuFinish();
+	}
+};
+
+static SongFilter
+ParseOptimized(std::initializer_list<const char *> args)
+{
+	SongFilter filter;
+	filter.Parse({args.begin(), args.size()});
+	filter.Optimize();
+	return filter;
+}
+
+TEST_F(OptimizeSongFilterTest, Reorder)
+{
+	EXPECT_EQ(ParseOptimized({"((Genre contains \"rock\") AND (base \"Artists/Z\"))"}).ToExpression(),
+		  "((base \"Artists/Z\") AND (Genre contains \"rock\"))");
+
+	EXPECT_EQ(ParseOptimized({"((any == \"x\") AND (Artist == \"y\") AND (file starts_with \"a/b\"))"}).ToExpression(),
+		  "((file starts_with \"a/b\") AND (Artist == \"y\") AND (any == \"x\"))");
+
+	/* items with the same cost retain their order */
+	EXPECT_EQ(ParseOptimized({"((Title == \"b\") AND (Artist == \"a\"))"}).ToExpression(),
+		  "((Title == \"b\") AND (Artist == \"a\"))");
+
+	/* nested expressions are reordered, too */
+	EXPECT_EQ(ParseOptimized({"(!((Artist contains \"a\") AND (Album == \"b\")))"}).ToExpression(),
+		  "(!((Album == \"b\") AND (Artist contains \"a\")))");
+}
+
+TEST_F(OptimizeSongFilterTest, Normalize)
+{
+	const std::array args{"((Genre contains \"rock\") AND (base \"Artists/Z\"))"};
+
+	SongFilter filter;
+	filter.Parse(args);
+	filter.Normalize();
+	EXPECT_EQ(filter.ToExpression(),
+		  "((Genre contains \"rock\") AND (base \"Artists/Z\"))");
+}
+
+TEST_F(OptimizeSongFilterTest, UriPrefix)
+{
+	EXPECT_EQ(ParseOptimized({"(Artist == \"a\")"}).GetUriPrefix(), "");
+	EXPECT_EQ(ParseOptimized({"(base \"a/b\")"}).GetUriPrefix(), "a/b");
+	EXPECT_EQ(ParseOptimized({"((base \"a\") AND (file starts_with \"a/b/c\"))"}).GetUriPrefix(), "a/b/c");
+	EXPECT_EQ(ParseOptimized({"(file == \"a/b.mp3\")"}).GetUriPrefix(), "a/b.mp3");
+
+	/* these do not constrain the prefix */
+	EXPECT_EQ(ParseOptimized({"(file contains \"a/b\")"}).GetUriPrefix(), "");
+	EXPECT_EQ(ParseOptimized({"(file != \"a/b\")"}).GetUriPrefix(), "");
+	EXPECT_EQ(ParseOptimized({"(file starts_with_ci \"a/b\")"}).GetUriPrefix(), "");
+}
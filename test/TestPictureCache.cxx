@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "db/cache/PictureCache.hxx"
+#include "db/cache/Config.hxx"
+#include "config/Block.hxx"
+
+#include <gtest/gtest.h>
+
+using std::string_view_literals::operator""sv;
+
+static PictureCacheConfig
+MakeConfig(const char *size)
+{
+	ConfigBlock block;
+	block.AddBlockParam("size", size);
+	return PictureCacheConfig{block};
+}
+
+static CachedPicture
+MakePicture(std::string_view mime_type, std::size_t size, char fill='x')
+{
+	CachedPicture picture;
+	picture.mime_type = mime_type;
+	picture.data.ResizeDiscard(size);
+	std::fill(picture.data.begin(), picture.data.end(), std::byte(fill));
+	return picture;
+}
+
+static constexpr PictureCache::TimePoint
+MakeTime(unsigned seconds) noexcept
+{
+	return PictureCache::TimePoint{std::chrono::seconds{seconds}};
+}
+
+TEST(PictureCache, Basic)
+{
+	PictureCache cache{MakeConfig("64 kB")};
+
+	EXPECT_EQ(cache.Get("foo", MakeTime(1)), nullptr);
+	EXPECT_EQ(cache.GetMisses(), 1U);
+
+	EXPECT_NE(cache.Put("foo", MakeTime(1), MakePicture("image/png", 100)),
+		  nullptr);
+
+	const auto *picture = cache.Get("foo", MakeTime(1));
+	ASSERT_NE(picture, nullptr);
+	EXPECT_EQ(picture->mime_type, "image/png"sv);
+	EXPECT_EQ(picture->GetData().size(), 100U);
+	EXPECT_EQ(picture->GetData().front(), std::byte('x'));
+	EXPECT_EQ(cache.GetHits(), 1U);
+
+	/* replace an existing entry */
+	cache.Put("foo", MakeTime(1), MakePicture("image/jpeg", 50, 'y'));
+	picture = cache.Get("foo", MakeTime(1));
+	ASSERT_NE(picture, nullptr);
+	EXPECT_EQ(picture->mime_type, "image/jpeg"sv);
+	EXPECT_EQ(picture->GetData().size(), 50U);
+	EXPECT_EQ(picture->GetData().front(), std::byte('y'));
+}
+
+TEST(PictureCache, Modified)
+{
+	PictureCache cache{MakeConfig("64 kB")};
+
+	cache.Put("foo", MakeTime(1), MakePicture("image/png", 100));
+	ASSERT_NE(cache.Get("foo", MakeTime(1)), nullptr);
+
+	/* the file was modified; the stale entry is discarded */
+	EXPECT_EQ(cache.Get("foo", MakeTime(2)), nullptr);
+	EXPECT_EQ(cache.Get("foo", MakeTime(1)), nullptr);
+}
+
+TEST(PictureCache, Invalidate)
+{
+	PictureCache cache{MakeConfig("64 kB")};
+
+	cache.Put("foo", MakeTime(1), MakePicture("image/png", 100));
+	cache.Put("bar", MakeTime(1), MakePicture("image/png", 100));
+	cache.Invalidate();
+	EXPECT_EQ(cache.Get("foo", MakeTime(1)), nullptr);
+	EXPECT_EQ(cache.Get("bar", MakeTime(1)), nullptr);
+}
+
+TEST(PictureCache, TooLarge)
+{
+	PictureCache cache{MakeConfig("64 kB")};
+
+	EXPECT_EQ(cache.Put("huge", MakeTime(1),
+			    MakePicture({}, cache.GetMaxItemSize())),
+		  nullptr);
+	EXPECT_EQ(cache.Get("huge", MakeTime(1)), nullptr);
+
+	EXPECT_NE(cache.Put("half", MakeTime(1),
+			    MakePicture({}, cache.GetMaxItemSize() / 2)),
+		  nullptr);
+	EXPECT_NE(cache.Get("half", MakeTime(1)), nullptr);
+}
+
+TEST(PictureCache, Filler)
+{
+	PictureCache cache{MakeConfig("64 kB")};
+	const auto picture = MakePicture({}, 100);
+	const auto data = picture.GetData();
+
+	PictureCacheFiller filler;
+	filler.Start(cache, "foo", MakeTime(1), data.size());
+	EXPECT_EQ(filler.Add(cache, "foo", 0, data.first(60)), nullptr);
+	EXPECT_EQ(cache.Get("foo", MakeTime(1)), nullptr);
+
+	const auto *result = filler.Add(cache, "foo", 60, data.subspan(60));
+	ASSERT_NE(result, nullptr);
+	EXPECT_EQ(result->GetData().size(), 100U);
+	EXPECT_EQ(result->GetData().back(), std::byte('x'));
+	EXPECT_EQ(cache.Get("foo", MakeTime(1)), result);
+}
+
+TEST(PictureCache, FillerMismatch)
+{
+	PictureCache cache{MakeConfig("64 kB")};
+	const auto picture = MakePicture({}, 100);
+	const auto data = picture.GetData();
+
+	PictureCacheFiller filler;
+
+	/* a gap between two chunks discards the picture */
+	filler.Start(cache, "foo", MakeTime(1), data.size());
+	filler.Add(cache, "foo", 0, data.first(40));
+	EXPECT_EQ(filler.Add(cache, "foo", 60, data.subspan(60)), nullptr);
+	EXPECT_EQ(filler.Add(cache, "foo", 40, data.subspan(40)), nullptr);
+
+	/* so does a chunk of a different file */
+	filler.Start(cache, "foo", MakeTime(1), data.size());
+	filler.Add(cache, "foo", 0, data.first(40));
+	EXPECT_EQ(filler.Add(cache, "bar", 40, data.subspan(40)), nullptr);
+	EXPECT_EQ(filler.Add(cache, "foo", 40, data.subspan(40)), nullptr);
+
+	/* and invalidating the cache */
+	filler.Start(cache, "foo", MakeTime(1), data.size());
+	filler.Add(cache, "foo", 0, data.first(40));
+	cache.Invalidate();
+	EXPECT_EQ(filler.Add(cache, "foo", 40, data.subspan(40)), nullptr);
+
+	EXPECT_EQ(cache.Get("foo", MakeTime(1)), nullptr);
+}
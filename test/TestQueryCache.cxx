@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "db/cache/QueryCache.hxx"
+#include "db/cache/Config.hxx"
+#include "config/Block.hxx"
+
+#include <gtest/gtest.h>
+
+static QueryCacheConfig
+MakeConfig(const char *size)
+{
+	ConfigBlock block;
+	block.AddBlockParam("size", size);
+	return QueryCacheConfig{block};
+}
+
+TEST(QueryCache, Basic)
+{
+	QueryCache cache{MakeConfig("64 kB")};
+
+	EXPECT_EQ(cache.Get("foo"), nullptr);
+	EXPECT_EQ(cache.GetMisses(), 1U);
+
+	cache.Put("foo", "file: foo\n", cache.GetSerial());
+
+	const auto *value = cache.Get("foo");
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(*value, "file: foo\n");
+	EXPECT_EQ(cache.GetHits(), 1U);
+	EXPECT_EQ(cache.Get("bar"), nullptr);
+	EXPECT_EQ(cache.GetMisses(), 2U);
+
+	/* replace an existing entry */
+	cache.Put("foo", "file: bar\n", cache.GetSerial());
+	value = cache.Get("foo");
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(*value, "file: bar\n");
+}
+
+TEST(QueryCache, Invalidate)
+{
+	QueryCache cache{MakeConfig("64 kB")};
+
+	const auto serial = cache.GetSerial();
+	cache.Put("foo", "file: foo\n", serial);
+	ASSERT_NE(cache.Get("foo"), nullptr);
+
+	cache.Invalidate();
+	EXPECT_EQ(cache.Get("foo"), nullptr);
+
+	/* a response generated before the invalidation is stale */
+	cache.Put("foo", "file: foo\n", serial);
+	EXPECT_EQ(cache.Get("foo"), nullptr);
+
+	cache.Put("foo", "file: foo\n", cache.GetSerial());
+	EXPECT_NE(cache.Get("foo"), nullptr);
+}
+
+TEST(QueryCache, TooLarge)
+{
+	QueryCache cache{MakeConfig("64 kB")};
+
+	cache.Put("huge", std::string(cache.GetMaxItemSize(), 'x'),
+		  cache.GetSerial());
+	EXPECT_EQ(cache.Get("huge"), nullptr);
+
+	cache.Put("half", std::string(cache.GetMaxItemSize() / 2, 'x'),
+		  cache.GetSerial());
+	EXPECT_NE(cache.Get("half"), nullptr);
+}
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "queue/Queue.hxx"
+#include "song/DetachedSong.hxx"
+#include "song/LightSong.hxx"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+Tag::Tag(const Tag &) noexcept {}
+void Tag::Clear() noexcept {}
+
+DetachedSong::operator LightSong() const noexcept
+{
+	return {uri.c_str(), tag};
+}
+
+/**
+ * The reference implementation: scan the whole range.
+ */
+static std::vector<unsigned>
+ScanChangedPositions(const Queue &queue, uint32_t version,
+		     unsigned start, unsigned end) noexcept
+{
+	std::vector<unsigned> result;
+	for (unsigned i = start; i < end; ++i)
+		if (queue.IsNewerAtPosition(i, version))
+			result.push_back(i);
+	return result;
+}
+
+static void
+CheckAllVersions(const Queue &queue)
+{
+	const unsigned length = queue.GetLength();
+
+	for (uint32_t version = 0; version <= queue.version + 1; ++version) {
+		EXPECT_EQ(ScanChangedPositions(queue, version, 0, length),
+			  queue.FindChangedPositions(version, 0, length));
+
+		if (length >= 4) {
+			EXPECT_EQ(ScanChangedPositions(queue, version,
+						       1, length - 2),
+				  queue.FindChangedPositions(version,
+							     1, length - 2));
+		}
+	}
+}
+
+static void
+Append(Queue &queue, unsigned n)
+{
+	for (unsigned i = 0; i < n; ++i)
+		queue.Append(DetachedSong(std::to_string(i) + ".ogg"), 0);
+	queue.IncrementVersion();
+}
+
+TEST(QueueChanges, Append)
+{
+	Queue queue(64);
+
+	CheckAllVersions(queue);
+
+	Append(queue, 8);
+	CheckAllVersions(queue);
+
+	Append(queue, 8);
+	CheckAllVersions(queue);
+
+	const uint32_t version = queue.version;
+	EXPECT_TRUE(queue.FindChangedPositions(version, 0, 16).empty());
+	EXPECT_EQ(16u, queue.FindChangedPositions(0, 0, 16).size());
+}
+
+TEST(QueueChanges, Modify)
+{
+	Queue queue(64);
+	Append(queue, 16);
+
+	queue.SetPriorityRange(4, 8, 10, -1);
+	queue.IncrementVersion();
+	CheckAllVersions(queue);
+
+	queue.SwapPositions(0, 15);
+	queue.IncrementVersion();
+	CheckAllVersions(queue);
+
+	queue.MovePostion(2, 12);
+	queue.IncrementVersion();
+	CheckAllVersions(queue);
+
+	queue.MoveRange(0, 3, 10);
+	queue.IncrementVersion();
+	CheckAllVersions(queue);
+
+	queue.random = true;
+	queue.ShuffleOrder();
+	queue.IncrementVersion();
+	CheckAllVersions(queue);
+}
+
+TEST(QueueChanges, Delete)
+{
+	Queue queue(64);
+	Append(queue, 16);
+
+	queue.DeletePosition(3);
+	queue.IncrementVersion();
+	CheckAllVersions(queue);
+
+	queue.DeleteRange(5, 9);
+	queue.IncrementVersion();
+	CheckAllVersions(queue);
+
+	/* the ids of deleted items get reused */
+	Append(queue, 4);
+	CheckAllVersions(queue);
+
+	queue.Clear();
+	queue.IncrementVersion();
+	CheckAllVersions(queue);
+
+	Append(queue, 4);
+	CheckAllVersions(queue);
+}
+
+TEST(QueueChanges, Overflow)
+{
+	Queue queue(Queue::CHANGE_LOG_SIZE);
+	Append(queue, Queue::CHANGE_LOG_SIZE / 2);
+
+	/* fill the log, overwriting the oldest entries */
+	for (unsigned i = 0; i < 8; ++i) {
+		queue.SetPriorityRange(0, Queue::CHANGE_LOG_SIZE / 4,
+				       i + 1, -1);
+		queue.IncrementVersion();
+	}
+
+	EXPECT_GT(queue.change_log_version, 1u);
+	CheckAllVersions(queue);
+}
+
+TEST(QueueChanges, DeleteRange)
+{
+	Queue queue(64);
+	Append(queue, 16);
+
+	queue.random = true;
+	queue.ShuffleOrder();
+
+	const unsigned id_before = queue.PositionToId(3);
+	const unsigned id_after = queue.PositionToId(12);
+	const unsigned id_deleted = queue.PositionToId(8);
+	queue.IncrementVersion();
+
+	const uint32_t version = queue.version;
+	queue.DeleteRange(4, 12);
+	queue.IncrementVersion();
+
+	EXPECT_EQ(8u, queue.GetLength());
+	EXPECT_EQ(3, queue.IdToPosition(id_before));
+	EXPECT_EQ(4, queue.IdToPosition(id_after));
+	EXPECT_EQ(-1, queue.IdToPosition(id_deleted));
+
+	/* the "order" array must still be a permutation */
+	std::vector<bool> seen(queue.GetLength());
+	for (unsigned i = 0; i < queue.GetLength(); ++i) {
+		const unsigned position = queue.OrderToPosition(i);
+		ASSERT_LT(position, queue.GetLength());
+		EXPECT_FALSE(seen[position]);
+		seen[position] = true;
+	}
+
+	/* only the shifted items have changed */
+	EXPECT_EQ((std::vector<unsigned>{4, 5, 6, 7}),
+		  queue.FindChangedPositions(version, 0,
+					     queue.GetLength()));
+	CheckAllVersions(queue);
+}
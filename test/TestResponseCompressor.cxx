@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "client/Compressor.hxx"
+#include "util/SpanCast.hxx"
+
+#include <gtest/gtest.h>
+
+#include <zlib.h>
+
+#include <cstdlib>
+#include <string>
+
+/**
+ * Parses the frames generated by #ResponseCompressor, just like a
+ * client would.
+ */
+class FrameDecoder {
+	z_stream z{};
+
+public:
+	std::string output;
+
+	FrameDecoder() noexcept {
+		inflateInit2(&z, 16 + MAX_WBITS);
+	}
+
+	~FrameDecoder() noexcept {
+		inflateEnd(&z);
+	}
+
+	void Feed(std::string_view frame) {
+		if (!frame.starts_with("gzip: ")) {
+			output.append(frame);
+			return;
+		}
+
+		const auto newline = frame.find('\n');
+		ASSERT_NE(newline, frame.npos);
+
+		const std::size_t size = std::strtoul(frame.data() + 6, nullptr, 10);
+		ASSERT_EQ(frame.size(), newline + 1 + size + 1);
+		ASSERT_EQ(frame.back(), '\n');
+
+		const auto data = frame.substr(newline + 1, size);
+		z.next_in = (Bytef *)const_cast<char *>(data.data());
+		z.avail_in = data.size();
+
+		do {
+			char buffer[4096];
+			z.next_out = (Bytef *)buffer;
+			z.avail_out = sizeof(buffer);
+
+			int result = inflate(&z, Z_SYNC_FLUSH);
+			ASSERT_TRUE(result == Z_OK || result == Z_BUF_ERROR);
+
+			output.append(buffer, (char *)z.next_out - buffer);
+		} while (z.avail_in > 0 || z.avail_out == 0);
+	}
+};
+
+TEST(ResponseCompressor, Small)
+{
+	ResponseCompressor c;
+	EXPECT_TRUE(c.IsEmpty());
+
+	c.Write(AsBytes(std::string_view{"OK\n"}));
+	EXPECT_FALSE(c.IsEmpty());
+
+	/* small frames are not compressed */
+	EXPECT_EQ(c.Flush(), "OK\n");
+	EXPECT_TRUE(c.IsEmpty());
+}
+
+TEST(ResponseCompressor, Large)
+{
+	ResponseCompressor c;
+	FrameDecoder decoder;
+	std::string expected;
+
+	for (unsigned i = 0; i < 3000; ++i) {
+		const auto line = "file: Artist/Album/" + std::to_string(i) + ".flac\n"
+			"Title: Song " + std::to_string(i % 13) + "\n";
+		expected += line;
+		c.Write(AsBytes(line));
+
+		if (i % 1000 == 999) {
+			const auto frame = c.Flush();
+			EXPECT_TRUE(frame.starts_with("gzip: "));
+			decoder.Feed(frame);
+		}
+	}
+
+	EXPECT_TRUE(c.IsEmpty());
+	EXPECT_EQ(decoder.output, expected);
+
+	/* after a large frame, small ones are sent uncompressed
+	   again */
+	c.Write(AsBytes(std::string_view{"OK\n"}));
+	decoder.Feed(c.Flush());
+	expected += "OK\n";
+
+	EXPECT_EQ(decoder.output, expected);
+}
@@ -166,3 +166,20 @@ TEST_F(StringFilterTest, FoldCase)
 	EXPECT_FALSE(f.Match("foo"));
 	EXPECT_FALSE(f.Match("FOOnëedleBAR"));
 }
+
+TEST_F(StringFilterTest, FoldCaseIsIn)
+{
+	const StringFilter f{"Needle", true, false, StringFilter::Position::ANYWHERE, false};
+
+	EXPECT_TRUE(f.Match("needle"));
+	EXPECT_TRUE(f.Match("NEEDLE"));
+	EXPECT_TRUE(f.Match("foo needle bar baz qux quux corge grault garply"));
+	EXPECT_TRUE(f.Match("FOO NEEDLE BAR BAZ QUX QUUX CORGE GRAULT GARPLY"));
+	EXPECT_FALSE(f.Match("foo needl bar baz qux quux corge grault garply"));
+	EXPECT_FALSE(f.Match(""));
+#ifdef HAVE_ICU
+	/* non-ASCII haystacks still get canonicalized */
+	EXPECT_TRUE(f.Match("Motörhead NEEDLE"));
+	EXPECT_TRUE(StringFilter("kelvin", true, false, StringFilter::Position::ANYWHERE, false).Match("Kelvin"));
+#endif
+}
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+/*
+ * Micro-benchmark for the hand-off of #MusicChunk objects from a
+ * producer thread (the decoder) to a consumer thread (the player):
+ * MusicBuffer/MusicPipe compared with a simple mutex-protected
+ * allocator and queue (which is how MusicBuffer and MusicPipe used
+ * to be implemented).
+ */
+
+#include "MusicBuffer.hxx"
+#include "MusicPipe.hxx"
+#include "MusicChunk.hxx"
+#include "thread/Mutex.hxx"
+
+#ifndef NDEBUG
+#include "pcm/AudioFormat.hxx"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr unsigned BUFFER_CHUNKS = 1024;
+
+/**
+ * Fill the chunk with something that MusicPipe::Push() accepts.
+ */
+static void
+PrepareChunk(MusicChunk &chunk, unsigned sequence) noexcept
+{
+#ifndef NDEBUG
+	chunk.audio_format = AudioFormat(44100, SampleFormat::S16, 2);
+#endif
+	chunk.length = 4;
+	chunk.replay_gain_serial = sequence;
+}
+
+class LockFree {
+	MusicBuffer buffer{BUFFER_CHUNKS};
+	MusicPipe pipe;
+
+public:
+	bool Produce(unsigned sequence) noexcept {
+		auto chunk = buffer.Allocate();
+		if (!chunk)
+			return false;
+
+		PrepareChunk(*chunk, sequence);
+		pipe.Push(std::move(chunk));
+		return true;
+	}
+
+	int Consume() noexcept {
+		if (pipe.Peek() == nullptr)
+			return -1;
+
+		auto chunk = pipe.Shift();
+		return chunk->replay_gain_serial;
+	}
+};
+
+/**
+ * A #MusicChunk followed by its data buffer, as allocated by
+ * #MusicBuffer.
+ */
+struct LockedChunk : MusicChunk {
+	std::byte data[CHUNK_SIZE - sizeof(MusicChunk)];
+
+	LockedChunk() noexcept
+		:MusicChunk(CHUNK_SIZE - sizeof(MusicChunk)) {}
+};
+
+class Locked {
+	std::vector<LockedChunk> chunks{BUFFER_CHUNKS};
+
+	Mutex buffer_mutex;
+
+	/**
+	 * The unused elements of #chunks.  Protected by
+	 * #buffer_mutex.
+	 */
+	std::vector<LockedChunk *> available;
+
+	mutable Mutex pipe_mutex;
+	std::deque<LockedChunk *> pipe;
+
+public:
+	Locked() noexcept {
+		available.reserve(chunks.size());
+		for (auto &i : chunks)
+			available.push_back(&i);
+	}
+
+	bool Produce(unsigned sequence) noexcept {
+		LockedChunk *chunk;
+
+		{
+			const std::scoped_lock protect{buffer_mutex};
+			if (available.empty())
+				return false;
+
+			chunk = available.back();
+			available.pop_back();
+		}
+
+		PrepareChunk(*chunk, sequence);
+
+		const std::scoped_lock protect{pipe_mutex};
+		pipe.push_back(chunk);
+		return true;
+	}
+
+	int Consume() noexcept {
+		LockedChunk *chunk;
+
+		{
+			const std::scoped_lock protect{pipe_mutex};
+			if (pipe.empty())
+				return -1;
+
+			chunk = pipe.front();
+			pipe.pop_front();
+		}
+
+		const int sequence = chunk->replay_gain_serial;
+
+		const std::scoped_lock protect{buffer_mutex};
+		available.push_back(chunk);
+		return sequence;
+	}
+};
+
+template<typename T>
+static void
+Run(const char *name, unsigned n)
+{
+	T t;
+	std::vector<Clock::time_point> pushed(n);
+	std::vector<Clock::duration> latency;
+	latency.reserve(n);
+
+	const auto start = Clock::now();
+
+	std::thread producer([&t, &pushed, n]{
+		for (unsigned i = 0; i < n;) {
+			pushed[i] = Clock::now();
+			if (t.Produce(i))
+				++i;
+			else
+				std::this_thread::yield();
+		}
+	});
+
+	for (unsigned i = 0; i < n;) {
+		const int sequence = t.Consume();
+		if (sequence < 0) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		latency.push_back(Clock::now() - pushed[sequence]);
+		++i;
+	}
+
+	producer.join();
+
+	const std::chrono::duration<double> duration = Clock::now() - start;
+
+	std::sort(latency.begin(), latency.end());
+	const auto percentile = [&latency](double p){
+		const std::chrono::duration<double, std::micro> d =
+			latency[std::size_t(p * (latency.size() - 1))];
+		return d.count();
+	};
+
+	printf("%-10s %12.0f chunks/s  latency p50=%.2fus p99=%.2fus p99.9=%.2fus max=%.2fus\n",
+	       name, n / duration.count(),
+	       percentile(0.5), percentile(0.99), percentile(0.999),
+	       percentile(1));
+}
+
+int
+main(int argc, char **argv)
+{
+	const unsigned n = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+	if (n == 0)
+		return EXIT_FAILURE;
+
+	Run<Locked>("mutex", n);
+	Run<LockFree>("lock-free", n);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+/*
+ * Micro-benchmark comparing StringSearch() with strstr() and
+ * StringSearchIgnoreCaseASCII() with strcasestr() on a synthetic set
+ * of tag values.
+ */
+
+#include "util/StringSearch.hxx"
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static std::vector<std::string>
+MakeHaystacks(std::size_t n)
+{
+	static constexpr const char *words[] = {
+		"the", "Love", "night", "Song", "of", "Blue", "rock",
+		"Remastered", "live", "Version", "feat.", "Mix",
+		"Symphony", "No.", "in", "Major", "Allegro", "Part",
+	};
+
+	std::mt19937 random(42);
+	std::uniform_int_distribution<std::size_t> word(0, std::size(words) - 1);
+	std::uniform_int_distribution<std::size_t> length(2, 12);
+
+	std::vector<std::string> result;
+	result.reserve(n);
+
+	for (std::size_t i = 0; i < n; ++i) {
+		std::string s;
+		for (std::size_t j = length(random); j > 0; --j) {
+			if (!s.empty())
+				s.push_back(' ');
+			s += words[word(random)];
+		}
+
+		result.emplace_back(std::move(s));
+	}
+
+	return result;
+}
+
+template<typename F>
+static void
+Run(const char *name, const std::vector<std::string> &haystacks,
+    unsigned iterations, F &&f)
+{
+	std::size_t matches = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned i = 0; i < iterations; ++i)
+		for (const auto &h : haystacks)
+			if (f(h.c_str()))
+				++matches;
+
+	const std::chrono::duration<double, std::nano> duration =
+		std::chrono::steady_clock::now() - start;
+
+	printf("%-32s %8.2f ns/string (%zu matches)\n", name,
+	       duration.count() / (double(haystacks.size()) * iterations),
+	       matches);
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *needle = argc > 1 ? argv[1] : "symphony no";
+	const std::string_view needle_view{needle};
+	const unsigned iterations = argc > 2 ? strtoul(argv[2], nullptr, 10) : 100;
+
+	const auto haystacks = MakeHaystacks(100000);
+
+	Run("strstr()", haystacks, iterations, [needle](const char *h){
+		return strstr(h, needle) != nullptr;
+	});
+
+	Run("StringSearch()", haystacks, iterations, [needle_view](const char *h){
+		return StringSearch(h, needle_view) != nullptr;
+	});
+
+	Run("strcasestr()", haystacks, iterations, [needle](const char *h){
+		return strcasestr(h, needle) != nullptr;
+	});
+
+	Run("StringSearchIgnoreCaseASCII()", haystacks, iterations, [needle_view](const char *h){
+		return StringSearchIgnoreCaseASCII(h, needle_view) != nullptr;
+	});
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "tag/Tag.hxx"
+#include "tag/Builder.hxx"
+
+#include <gtest/gtest.h>
+
+static Tag
+MakeTestTag() noexcept
+{
+	TagBuilder builder;
+	builder.AddItem(TAG_ARTIST, "foo");
+	builder.AddItem(TAG_TITLE, "bar");
+	return builder.Commit();
+}
+
+TEST(Tag, CopyShares)
+{
+	const Tag a = MakeTestTag();
+	ASSERT_EQ(2u, a.num_items);
+
+	const Tag b{a};
+	EXPECT_EQ(a.items, b.items);
+	EXPECT_EQ(a, b);
+
+	{
+		const Tag c{b};
+		EXPECT_EQ(a.items, c.items);
+	}
+
+	EXPECT_STREQ("foo", b.GetValue(TAG_ARTIST));
+	EXPECT_STREQ("bar", b.GetValue(TAG_TITLE));
+}
+
+TEST(Tag, BuilderFromShared)
+{
+	Tag a = MakeTestTag();
+	Tag b{a};
+
+	/* moving a shared Tag into a TagBuilder must not steal the
+	   references of the other Tag */
+	TagBuilder builder{std::move(b)};
+	EXPECT_EQ(nullptr, b.items);
+	EXPECT_EQ(0u, b.num_items);
+
+	builder.RemoveType(TAG_TITLE);
+	builder.AddItem(TAG_ALBUM, "baz");
+	const Tag c = builder.Commit();
+
+	EXPECT_NE(a.items, c.items);
+	EXPECT_STREQ("foo", c.GetValue(TAG_ARTIST));
+	EXPECT_STREQ("baz", c.GetValue(TAG_ALBUM));
+	EXPECT_EQ(nullptr, c.GetValue(TAG_TITLE));
+
+	/* the original is unmodified */
+	EXPECT_STREQ("foo", a.GetValue(TAG_ARTIST));
+	EXPECT_STREQ("bar", a.GetValue(TAG_TITLE));
+	EXPECT_EQ(nullptr, a.GetValue(TAG_ALBUM));
+}
+
+TEST(Tag, BuilderFromExclusive)
+{
+	Tag a = MakeTestTag();
+
+	TagBuilder builder;
+	builder = std::move(a);
+	EXPECT_EQ(nullptr, a.items);
+
+	const Tag b = builder.Commit();
+	EXPECT_STREQ("foo", b.GetValue(TAG_ARTIST));
+	EXPECT_STREQ("bar", b.GetValue(TAG_TITLE));
+}
+
+TEST(Tag, Empty)
+{
+	TagBuilder builder;
+	const Tag a = builder.Commit();
+	EXPECT_EQ(nullptr, a.items);
+	EXPECT_TRUE(a.IsEmpty());
+
+	const Tag b{a};
+	EXPECT_TRUE(b.IsEmpty());
+}
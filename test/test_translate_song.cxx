@@ -23,8 +23,11 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 bool
 uri_supported_scheme(const char *uri) noexcept
@@ -98,6 +101,15 @@ DatabaseDetachSong([[maybe_unused]] const Database &db,
 	throw std::runtime_error("No such song");
 }
 
+DetachedSong
+DatabaseDetachSong([[maybe_unused]] const Storage *_storage,
+		   [[maybe_unused]] const LightSong &song) noexcept
+{
+	/* not used: the tests never call SongLoader::LoadSongs()
+	   with a #Database */
+	abort();
+}
+
 bool
 DetachedSong::LoadFile(Path path)
 {
@@ -295,3 +307,32 @@ TEST_F(TranslateSongTest, Backslash)
 						   loader));
 #endif
 }
+
+TEST_F(TranslateSongTest, LoadSongs)
+{
+	const SongLoader loader(nullptr, storage);
+
+	const std::array uris{
+		"http://example.com/foo.ogg",
+		uri1,
+		"/foo/doesntexist.ogg",
+		uri2,
+	};
+
+	const auto songs = loader.LoadSongs(uris);
+	ASSERT_EQ(songs.size(), uris.size());
+
+	ASSERT_TRUE(songs[0]);
+	EXPECT_EQ(ToString(*songs[0]),
+		  ToString(DetachedSong("http://example.com/foo.ogg")));
+
+	ASSERT_TRUE(songs[1]);
+	EXPECT_EQ(ToString(*songs[1]),
+		  ToString(DetachedSong(uri1, MakeTag1a())));
+
+	/* file does not exist */
+	EXPECT_FALSE(songs[2]);
+
+	/* relative URI, but no database */
+	EXPECT_FALSE(songs[3]);
+}
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "util/LRUCache.hxx"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+using StringCache = LRUCache<std::string, std::string,
+			     std::hash<std::string_view>,
+			     std::equal_to<std::string_view>>;
+
+TEST(LRUCache, Basic)
+{
+	StringCache cache{100};
+	EXPECT_EQ(cache.GetMaxSize(), 100U);
+	EXPECT_EQ(cache.GetSize(), 0U);
+	EXPECT_EQ(cache.Get("foo"), nullptr);
+
+	const auto *value = cache.Put("foo", "bar", 10);
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(*value, "bar");
+	EXPECT_EQ(cache.GetSize(), 10U);
+
+	/* lookup with a different key type */
+	value = cache.Get(std::string_view{"foo"});
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(*value, "bar");
+
+	/* replace an existing item */
+	cache.Put("foo", "baz", 20);
+	EXPECT_EQ(cache.GetSize(), 20U);
+	value = cache.Get("foo");
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(*value, "baz");
+
+	cache.Remove("foo");
+	EXPECT_EQ(cache.Get("foo"), nullptr);
+	EXPECT_EQ(cache.GetSize(), 0U);
+
+	/* removing a nonexistent item is a no-op */
+	cache.Remove("foo");
+}
+
+TEST(LRUCache, TooLarge)
+{
+	StringCache cache{100};
+	cache.Put("a", "a", 60);
+
+	EXPECT_EQ(cache.Put("huge", "x", 101), nullptr);
+	EXPECT_EQ(cache.Get("huge"), nullptr);
+
+	/* a rejected item does not evict anything */
+	EXPECT_NE(cache.Get("a"), nullptr);
+	EXPECT_EQ(cache.GetSize(), 60U);
+
+	/* an item may fill the whole cache */
+	EXPECT_NE(cache.Put("full", "x", 100), nullptr);
+	EXPECT_EQ(cache.Get("a"), nullptr);
+	EXPECT_EQ(cache.GetSize(), 100U);
+}
+
+TEST(LRUCache, Evict)
+{
+	StringCache cache{100};
+
+	for (unsigned i = 0; i < 10; ++i)
+		cache.Put(std::to_string(i), "x", 10);
+	EXPECT_EQ(cache.GetSize(), 100U);
+
+	/* the least recently used item is evicted */
+	cache.Put("10", "x", 10);
+	EXPECT_EQ(cache.Get("0"), nullptr);
+	EXPECT_NE(cache.Get("1"), nullptr);
+
+	/* the lookup above has refreshed "1"; a large item evicts
+	   as many of the oldest items as needed */
+	cache.Put("big", "x", 30);
+	EXPECT_EQ(cache.GetSize(), 100U);
+	EXPECT_NE(cache.Get("1"), nullptr);
+	EXPECT_EQ(cache.Get("2"), nullptr);
+	EXPECT_EQ(cache.Get("3"), nullptr);
+	EXPECT_EQ(cache.Get("4"), nullptr);
+	EXPECT_NE(cache.Get("5"), nullptr);
+	EXPECT_NE(cache.Get("big"), nullptr);
+}
+
+TEST(LRUCache, Clear)
+{
+	StringCache cache{100};
+	cache.Put("foo", "x", 10);
+	cache.Put("bar", "x", 10);
+
+	cache.Clear();
+	EXPECT_EQ(cache.GetSize(), 0U);
+	EXPECT_EQ(cache.Get("foo"), nullptr);
+	EXPECT_EQ(cache.Get("bar"), nullptr);
+
+	/* the cache is still usable */
+	cache.Put("foo", "x", 10);
+	EXPECT_NE(cache.Get("foo"), nullptr);
+}
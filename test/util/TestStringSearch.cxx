@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The Music Player Daemon Project
+
+#include "util/StringSearch.hxx"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+/**
+ * Compare with std::string_view::find() at all haystack offsets and
+ * lengths, to exercise the vector loop and the scalar tail.
+ */
+static void
+CheckSearch(std::string_view haystack, std::string_view needle)
+{
+	for (std::size_t start = 0; start <= haystack.size(); ++start) {
+		for (std::size_t end = start; end <= haystack.size(); ++end) {
+			const auto h = haystack.substr(start, end - start);
+			const auto i = h.find(needle);
+			const char *expected = i != h.npos
+				? h.data() + i
+				: nullptr;
+
+			EXPECT_EQ(StringSearch(h, needle), expected);
+		}
+	}
+}
+
+TEST(StringSearch, Basic)
+{
+	const std::string haystack = "The quick brown fox jumps over the lazy dog; "
+		"the quick brown fox jumps over the lazy dog again";
+
+	CheckSearch(haystack, "");
+	CheckSearch(haystack, "T");
+	CheckSearch(haystack, "g");
+	CheckSearch(haystack, "he");
+	CheckSearch(haystack, "fox");
+	CheckSearch(haystack, "lazy dog again");
+	CheckSearch(haystack, "lazy cat");
+	CheckSearch(haystack, "x");
+	CheckSearch(haystack, "again!");
+}
+
+TEST(StringSearch, NonASCII)
+{
+	const std::string haystack = "Motörhead \xff\x80 Björk Sigur Rós, Mötley Crüe";
+
+	CheckSearch(haystack, "ö");
+	CheckSearch(haystack, "Björk");
+	CheckSearch(haystack, "\xff\x80");
+	CheckSearch(haystack, "Crüe");
+}
+
+TEST(StringSearch, IgnoreCaseASCII)
+{
+	const std::string_view haystack = "Some Artist - THE ALBUM TITLE (Deluxe Edition) [Disc 2]";
+
+	EXPECT_EQ(StringSearchIgnoreCaseASCII(haystack, "some"), haystack.data());
+	EXPECT_EQ(StringSearchIgnoreCaseASCII(haystack, "the album"), haystack.data() + 14);
+	EXPECT_EQ(StringSearchIgnoreCaseASCII(haystack, "[disc 2]"), haystack.data() + 47);
+	EXPECT_EQ(StringSearchIgnoreCaseASCII(haystack, "2]"), haystack.data() + 53);
+	EXPECT_EQ(StringSearchIgnoreCaseASCII(haystack, "disc 3"), nullptr);
+
+	/* non-letters must not be folded */
+	EXPECT_EQ(StringSearchIgnoreCaseASCII("[@]", "{`}"), nullptr);
+	EXPECT_EQ(StringSearchIgnoreCaseASCII("\xc3\x96", "\xe3\xb6"), nullptr);
+}
+
+TEST(StringSearch, IsASCII)
+{
+	EXPECT_TRUE(StringIsASCII(""));
+	EXPECT_TRUE(StringIsASCII("The quick brown fox jumps over the lazy dog"));
+	EXPECT_FALSE(StringIsASCII("The quick brown fox jumps over the lazy dög"));
+	EXPECT_FALSE(StringIsASCII("\x80"));
+}